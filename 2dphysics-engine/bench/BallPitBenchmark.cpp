@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+void BenchmarkBallPit()
+{
+	const int sizes[] = { 1000, 5000, 20000 };
+	const BroadphaseType types[] = { ALL_PAIRS, AABB_TREE, SPATIAL_HASH };
+	const int warmupSteps = 5;
+	const int steps = 20;
+	const float dt = 1.0f / 60.0f;
+
+	printf("%8s | %-14s | %14s %10s %10s\n", "balls", "broadphase", "AABB tests", "pairs", "step ms");
+
+	for (int numBalls : sizes)
+	{
+		for (BroadphaseType type : types)
+		{
+			// The all pairs loop is only affordable for the smaller scenes
+			if (type == ALL_PAIRS && numBalls > 5000)
+			{
+				printf("%8d | %-14s | %14s %10s %10s\n", numBalls, BroadphaseName(type), "-", "-", "skipped");
+				continue;
+			}
+
+			World* world = CreateBallPitScene(numBalls);
+			world->SetBroadphase(CreateBroadphase(type));
+			world->SetAllowSleeping(false); // compare the broadphases with every body awake
+
+			for (int i = 0; i < warmupSteps; i++)
+			{
+				world->Update(dt);
+			}
+
+			Timer timer;
+			for (int i = 0; i < steps; i++)
+			{
+				world->Update(dt);
+			}
+			double stepMs = timer.ElapsedMs() / steps;
+
+			const BroadphaseStats& stats = world->GetBroadphase()->GetStats();
+			printf("%8d | %-14s | %14d %10d %10.2f\n", numBalls, BroadphaseName(type), stats.overlapTests, stats.pairs, stepMs);
+
+			delete world;
+		}
+	}
+}
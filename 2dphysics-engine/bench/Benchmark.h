@@ -0,0 +1,80 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "../src/Physics/World.h"
+#include "../src/AllocationCounter.h"
+
+#include <chrono>
+
+// Wall clock timer used to measure the benchmarks
+struct Timer
+{
+	std::chrono::steady_clock::time_point start;
+
+	Timer();
+	void Reset();
+	double ElapsedMs() const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Scenes (built programmatically, always with the same random seed)
+///////////////////////////////////////////////////////////////////////////////
+// Boxes and balls scattered on a jittered grid, with a constant density no
+// matter how many bodies are requested
+World* CreateScatteredScene(int numBodies);
+
+// Lots of balls of nearly the same radius packed inside a static container
+World* CreateBallPitScene(int numBalls);
+
+// Columns of boxes resting on top of each other on a static floor
+World* CreateBoxStacksScene(int numBoxes, int boxesPerColumn);
+
+// A single pyramid of boxes (numRows * (numRows + 1) / 2 boxes), one big island
+World* CreatePyramidScene(int numRows);
+
+// Chains of balls linked by joints, hanging from static anchors. They start
+// horizontal, swing down and tangle on a static floor
+World* CreateChainScene(int numChains, int linksPerChain);
+
+// Boxes, balls and convex polygons of 3 to 8 vertices falling into a container
+World* CreateMixedPolygonsScene(int numBodies);
+
+// Towers of posts and planks with a heavy ball thrown at the first one
+World* CreateTowerScene(int numTowers, int floorsPerTower);
+
+///////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////
+void BenchmarkBroadphase();
+void BenchmarkBallPit();
+
+void BenchmarkSweepAndPrune();
+void BenchmarkSolver();
+void BenchmarkBoxStack();
+void BenchmarkWarmStart();
+void BenchmarkSleep();
+void BenchmarkIslands();
+void BenchmarkNarrowphase();
+void BenchmarkColoring();
+void BenchmarkIntegration();
+void BenchmarkWideSolver();
+void BenchmarkPools();
+void BenchmarkFrameArena();
+void BenchmarkDispatch();
+void BenchmarkBoxBox();
+void BenchmarkHillClimbing();
+void BenchmarkScenes();
+
+///////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////
+const char* BroadphaseName(BroadphaseType type);
+Broadphase* CreateBroadphase(BroadphaseType type);
+
+// Hash of the state of all the bodies, used to check that results are deterministic
+unsigned long long HashBodies(World* world);
+
+// Same for contacts, to check that two collision tests find the same ones
+unsigned long long HashContacts(const Contact* contacts, int numContacts);
+
+#endif
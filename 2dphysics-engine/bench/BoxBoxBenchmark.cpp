@@ -0,0 +1,134 @@
+#include "Benchmark.h"
+#include "../src/Physics/CollisionDetection.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+struct BodyPair
+{
+	Body* a;
+	Body* b;
+};
+
+// Pairs per microsecond of a collision test over all the pairs (best of a few
+// runs) and the hash of the contacts it found
+static double MeasureThroughput(const std::vector<BodyPair>& pairs, CollisionFunction isColliding, int& numContacts, unsigned long long& hash)
+{
+	const int runs = 20;
+
+	std::vector<Contact> contacts(pairs.size() * MAX_CONTACTS_PER_PAIR);
+	double bestMs = 1e30;
+	for (int run = 0; run < runs; run++)
+	{
+		numContacts = 0;
+		Timer timer;
+		for (auto& pair : pairs)
+		{
+			int count = 0;
+			isColliding(pair.a, pair.b, &contacts[numContacts], count);
+			numContacts += count;
+		}
+		bestMs = std::min(bestMs, timer.ElapsedMs());
+	}
+
+	hash = HashContacts(contacts.data(), numContacts);
+	return pairs.size() / (bestMs * 1000.0);
+}
+
+static void RunPairs(const char* name, const std::vector<BodyPair>& pairs)
+{
+	int polygonContacts, boxContacts;
+	unsigned long long polygonHash, boxHash;
+	double polygonRate = MeasureThroughput(pairs, CollisionDetection::IsCollidingPolygonPolygon, polygonContacts, polygonHash);
+	double boxRate = MeasureThroughput(pairs, CollisionDetection::IsCollidingBoxBox, boxContacts, boxHash);
+
+	printf("%-22s %8d %9d %14.2f %14.2f %8.2fx %s\n", name, (int)pairs.size(), boxContacts, polygonRate, boxRate,
+		boxRate / polygonRate, polygonHash == boxHash ? "same" : "DIFFERENT");
+}
+
+// Random boxes in pairs, the second box of a pair at most "maxOffset" away from the first one
+static World* CreateRandomPairs(int numPairs, float maxOffset, std::vector<BodyPair>& pairs)
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> size(10.0f, 60.0f);
+	std::uniform_real_distribution<float> offset(-maxOffset, maxOffset);
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+
+	World* world = new World(-9.8);
+	for (int i = 0; i < numPairs; i++)
+	{
+		// Far from the other pairs, they are only checked against each other
+		float x = (i % 100) * 200.0f;
+		float y = (i / 100) * 200.0f;
+
+		Body* a = new Body(BoxShape(size(random), size(random)), x, y, 1.0);
+		Body* b = new Body(BoxShape(size(random), size(random)), x + offset(random), y + offset(random), 1.0);
+		a->SetRotation(angle(random));
+		b->SetRotation(angle(random));
+		world->AddBody(a);
+		world->AddBody(b);
+		pairs.push_back({ a, b });
+	}
+	return world;
+}
+
+void BenchmarkBoxBox()
+{
+	printf("Box-box pairs per microsecond, generic polygon test against the box one (best of 20 runs)\n");
+	printf("%-22s %8s %9s %14s %14s %9s %s\n", "pairs", "count", "contacts", "polygon", "box", "speedup", "contacts");
+
+	// Resting contacts: the broadphase pairs of settled box stacks
+	{
+		World* world = CreateBoxStacksScene(4000, 10);
+		world->SetAllowSleeping(false);
+		for (int i = 0; i < 60; i++)
+		{
+			world->Update(1.0f / 60.0f);
+		}
+
+		std::vector<Body*>& bodies = world->GetBodies();
+		AABBTree broadphase;
+		for (int i = 0; i < (int)bodies.size(); i++)
+		{
+			broadphase.CreateProxy(i, bodies[i]->shape->GetAABB(bodies[i]->GetTransform()), bodies[i]->IsStatic());
+		}
+		std::vector<BroadphasePair> broadphasePairs;
+		broadphase.FindPairs(broadphasePairs);
+
+		std::vector<BodyPair> pairs;
+		for (auto& pair : broadphasePairs)
+		{
+			pairs.push_back({ bodies[pair.a], bodies[pair.b] });
+		}
+		RunPairs("resting stacks", pairs);
+		delete world;
+	}
+
+	// Random sizes and rotations, mostly overlapping
+	{
+		std::vector<BodyPair> pairs;
+		World* world = CreateRandomPairs(20000, 20.0f, pairs);
+		RunPairs("rotated, overlapping", pairs);
+		delete world;
+	}
+
+	// Farther apart, only the pairs whose bounding circles touch: many of the
+	// boxes are separated, the separating axis test has to find the axis
+	{
+		std::vector<BodyPair> pairs;
+		World* world = CreateRandomPairs(20000, 70.0f, pairs);
+		std::vector<BodyPair> nearMisses;
+		for (auto& pair : pairs)
+		{
+			const float radiusSum = ((PolygonShape*)pair.a->shape)->boundingRadius + ((PolygonShape*)pair.b->shape)->boundingRadius;
+			if ((pair.b->GetPosition() - pair.a->GetPosition()).MagnitudeSquared() <= radiusSum * radiusSum)
+			{
+				nearMisses.push_back(pair);
+			}
+		}
+		RunPairs("rotated, near misses", nearMisses);
+		delete world;
+	}
+}
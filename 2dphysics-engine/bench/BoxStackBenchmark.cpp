@@ -0,0 +1,31 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+void BenchmarkBoxStack()
+{
+	const int numBoxes = 500;
+	const int boxesPerColumn = 5;
+	const int settleSteps = 60;
+	const int steps = 300;
+	const float dt = 1.0f / 60.0f;
+
+	World* world = CreateBoxStacksScene(numBoxes, boxesPerColumn);
+	world->SetAllowSleeping(false); // the stacks would fall asleep and cost nothing
+
+	for (int i = 0; i < settleSteps; i++)
+	{
+		world->Update(dt);
+	}
+
+	Timer timer;
+	for (int i = 0; i < steps; i++)
+	{
+		world->Update(dt);
+	}
+	double stepMs = timer.ElapsedMs() / steps;
+
+	printf("%d boxes in columns of %d: %.3f ms/step (%d steps)\n", numBoxes, boxesPerColumn, stepMs, steps);
+
+	delete world;
+}
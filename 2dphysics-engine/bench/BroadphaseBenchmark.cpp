@@ -0,0 +1,60 @@
+#include "Benchmark.h"
+#include "../src/Physics/CollisionDetection.h"
+
+#include <cstdio>
+
+// Time the narrowphase over every pair of bodies, like World::Update used to do
+static double TimeAllPairs(std::vector<Body*>& bodies, int& numColliding)
+{
+	Timer timer;
+	Contact contacts[MAX_CONTACTS_PER_PAIR];
+	int numContacts;
+	numColliding = 0;
+	for (int i = 0; i < (int)bodies.size(); i++)
+	{
+		for (int j = i + 1; j < (int)bodies.size(); j++)
+		{
+			if (CollisionDetection::IsColliding(bodies[i], bodies[j], contacts, numContacts))
+			{
+				numColliding++;
+			}
+		}
+	}
+	return timer.ElapsedMs();
+}
+
+void BenchmarkBroadphase()
+{
+	const int sizes[] = { 1000, 10000, 50000 };
+	const int steps = 10;
+	const float dt = 1.0f / 60.0f;
+
+	printf("%8s | %15s %12s | %15s %10s %8s %14s\n", "bodies", "all-pairs tests", "all-pairs ms", "tree AABB tests", "pairs", "height", "step ms (tree)");
+
+	for (int numBodies : sizes)
+	{
+		World* world = CreateScatteredScene(numBodies);
+
+		// The brute force loop is only affordable for the smaller scenes
+		long long allPairsTests = (long long)numBodies * (numBodies - 1) / 2;
+		char allPairsMs[32] = "skipped";
+		if (numBodies <= 10000)
+		{
+			int numColliding;
+			snprintf(allPairsMs, sizeof(allPairsMs), "%.2f", TimeAllPairs(world->GetBodies(), numColliding));
+		}
+
+		Timer timer;
+		for (int i = 0; i < steps; i++)
+		{
+			world->Update(dt);
+		}
+		double stepMs = timer.ElapsedMs() / steps;
+
+		const AABBTree* tree = (const AABBTree*)world->GetBroadphase();
+		const BroadphaseStats& stats = tree->GetStats();
+		printf("%8d | %15lld %12s | %15d %10d %8d %14.2f\n", numBodies, allPairsTests, allPairsMs, stats.overlapTests, stats.pairs, tree->GetHeight(), stepMs);
+
+		delete world;
+	}
+}
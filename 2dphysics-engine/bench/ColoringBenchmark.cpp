@@ -0,0 +1,57 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <thread>
+
+// Steps the pyramid and returns the ms/step, the state hash and how far the top box fell
+static double RunPyramid(int numRows, bool graphColoring, int numThreads, int steps, unsigned long long& hash, float& topDrop)
+{
+	const float dt = 1.0f / 60.0f;
+
+	World* world = CreatePyramidScene(numRows);
+	world->SetAllowSleeping(false);
+	world->SetGraphColoring(graphColoring);
+	world->SetNumThreads(numThreads);
+
+	Body* top = world->GetBodies().back();
+	float topStart = top->GetPosition().y;
+
+	Timer timer;
+	for (int i = 0; i < steps; i++)
+	{
+		world->Update(dt);
+	}
+	double stepMs = timer.ElapsedMs() / steps;
+
+	hash = HashBodies(world);
+	topDrop = top->GetPosition().y - topStart;
+
+	delete world;
+	return stepMs;
+}
+
+void BenchmarkColoring()
+{
+	const int numRows = 141; // 10011 boxes
+	const int steps = 60;
+	const int threadCounts[] = { 1, 2, 4, 8 };
+
+	printf("pyramid of %d rows (%d boxes, one island), %d steps, %u hardware threads\n", numRows, numRows * (numRows + 1) / 2, steps, std::thread::hardware_concurrency());
+	printf("%-10s %8s %10s %9s %14s %18s\n", "coloring", "threads", "ms/step", "speedup", "top drop px", "state hash");
+
+	unsigned long long hash;
+	float topDrop;
+	double serialMs = RunPyramid(numRows, false, 1, steps, hash, topDrop);
+	printf("%-10s %8d %10.3f %8.2fx %14.2f %18llx\n", "off", 1, serialMs, 1.0, topDrop, hash);
+
+	unsigned long long coloredHash = 0;
+	for (int numThreads : threadCounts)
+	{
+		double stepMs = RunPyramid(numRows, true, numThreads, steps, hash, topDrop);
+		if (numThreads == 1)
+		{
+			coloredHash = hash;
+		}
+		printf("%-10s %8d %10.3f %8.2fx %14.2f %18llx %s\n", "on", numThreads, stepMs, serialMs / stepMs, topDrop, hash, hash == coloredHash ? "" : "MISMATCH");
+	}
+}
@@ -0,0 +1,50 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+// Counts the global allocations made by World::Update() once the frame arena,
+// the manifold cache and the other buffers have grown to what the scene needs
+static void RunScene(const char* name, World* world, int numThreads)
+{
+	const int warmupSteps = 120;
+	const int steps = 120;
+	const float dt = 1.0f / 60.0f;
+
+	world->SetAllowSleeping(false);
+	world->SetNumThreads(numThreads);
+	for (int i = 0; i < warmupSteps; i++)
+	{
+		world->Update(dt);
+	}
+
+	long long arenaAllocations = world->GetFrameArenaStats().heapAllocations;
+	long long allocations = GetAllocationCount();
+	Timer timer;
+	for (int i = 0; i < steps; i++)
+	{
+		world->Update(dt);
+	}
+	double stepMs = timer.ElapsedMs() / steps;
+
+	const FrameArenaStats& stats = world->GetFrameArenaStats();
+	printf("%-16s %8d %8d %10.3f %12.2f %12lld %10.1f %10.1f %8d\n", name, numThreads, (int)world->GetBodies().size(), stepMs,
+		(double)(GetAllocationCount() - allocations) / steps, stats.heapAllocations - arenaAllocations,
+		stats.capacity / 1024.0, stats.peak / 1024.0, stats.blocks);
+
+	delete world;
+}
+
+void BenchmarkFrameArena()
+{
+	printf("heap allocations of World::Update() after %d warm up steps (sleeping disabled)\n", 120);
+	printf("%-16s %8s %8s %10s %12s %12s %10s %10s %8s\n", "scene", "threads", "bodies", "ms/step", "allocs/step", "arena", "arena", "peak", "arena");
+	printf("%-16s %8s %8s %10s %12s %12s %10s %10s %8s\n", "", "", "", "", "(global)", "new blocks", "KiB", "KiB", "blocks");
+
+	for (int numThreads : { 1, 4 })
+	{
+		RunScene("pyramid 40", CreatePyramidScene(40), numThreads);
+		RunScene("box stacks 4000", CreateBoxStacksScene(4000, 10), numThreads);
+		RunScene("ball pit 5000", CreateBallPitScene(5000), numThreads);
+		RunScene("scattered 10000", CreateScatteredScene(10000), numThreads);
+	}
+}
@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+
+Timer::Timer()
+{
+	Reset();
+}
+
+void Timer::Reset()
+{
+	start = std::chrono::steady_clock::now();
+}
+
+double Timer::ElapsedMs() const
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+const char* BroadphaseName(BroadphaseType type)
+{
+	switch (type)
+	{
+	case ALL_PAIRS:
+		return "all pairs";
+	case AABB_TREE:
+		return "AABB tree";
+	case SPATIAL_HASH:
+		return "spatial hash";
+	case SWEEP_AND_PRUNE:
+		return "sweep and prune";
+	}
+	return "unknown";
+}
+
+Broadphase* CreateBroadphase(BroadphaseType type)
+{
+	switch (type)
+	{
+	case ALL_PAIRS:
+		return new AllPairs();
+	case AABB_TREE:
+		return new AABBTree();
+	case SPATIAL_HASH:
+		return new SpatialHash();
+	default:
+		return new SweepAndPrune();
+	}
+}
+
+// FNV-1a over the raw bytes, so two states only match if they are bit for bit identical
+static void HashBytes(unsigned long long& hash, const void* data, int size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (int i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+}
+
+unsigned long long HashBodies(World* world)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (auto body : world->GetBodies())
+	{
+		HashBytes(hash, &body->GetPosition(), sizeof(body->GetPosition()));
+		float rotation = body->GetRotation();
+		HashBytes(hash, &rotation, sizeof(rotation));
+		HashBytes(hash, &body->GetVelocity(), sizeof(body->GetVelocity()));
+		float angularVelocity = body->GetAngularVelocity();
+		HashBytes(hash, &angularVelocity, sizeof(angularVelocity));
+	}
+	return hash;
+}
+
+unsigned long long HashContacts(const Contact* contacts, int numContacts)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (int c = 0; c < numContacts; c++)
+	{
+		const Contact& contact = contacts[c];
+		const float values[] = { contact.start.x, contact.start.y, contact.end.x, contact.end.y, contact.normal.x, contact.normal.y };
+		HashBytes(hash, values, sizeof(values));
+		hash ^= contact.feature;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
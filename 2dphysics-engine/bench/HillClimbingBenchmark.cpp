@@ -0,0 +1,132 @@
+#include "Benchmark.h"
+#include "../src/Physics/CollisionDetection.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+struct PolygonPair
+{
+	Body* a;
+	Body* b;
+};
+
+// Regular polygon with "numVertices" vertices, slightly squashed so the edges
+// don't all have the same length, wound like BoxShape
+static PolygonShape CreateRoundPolygon(int numVertices, float radius)
+{
+	std::vector<Vec2> vertices;
+	for (int i = 0; i < numVertices; i++)
+	{
+		float angle = 2.0f * 3.14159265f * i / numVertices;
+		vertices.push_back(Vec2(radius * std::cos(angle), radius * 0.8f * std::sin(angle)));
+	}
+	return PolygonShape(vertices);
+}
+
+// Random polygons in pairs, the second one of a pair at most "maxOffset" away
+// from the first one. Only the pairs whose bounding circles touch are kept
+static World* CreatePolygonPairs(int numPairs, int numVertices, float maxOffset, std::vector<PolygonPair>& pairs)
+{
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> radius(10.0f, 30.0f);
+	std::uniform_real_distribution<float> offset(-maxOffset, maxOffset);
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+
+	World* world = new World(-9.8);
+	for (int i = 0; i < numPairs; i++)
+	{
+		float x = (i % 100) * 200.0f;
+		float y = (i / 100) * 200.0f;
+
+		Body* a = new Body(CreateRoundPolygon(numVertices, radius(random)), x, y, 1.0);
+		Body* b = new Body(CreateRoundPolygon(numVertices, radius(random)), x + offset(random), y + offset(random), 1.0);
+		a->SetRotation(angle(random));
+		b->SetRotation(angle(random));
+		world->AddBody(a);
+		world->AddBody(b);
+
+		const float radiusSum = ((PolygonShape*)a->shape)->boundingRadius + ((PolygonShape*)b->shape)->boundingRadius;
+		if ((b->GetPosition() - a->GetPosition()).MagnitudeSquared() <= radiusSum * radiusSum)
+		{
+			pairs.push_back({ a, b });
+		}
+	}
+	return world;
+}
+
+// Pairs per microsecond of the polygon test with the given vertex threshold
+// (best of a few runs), and the contacts it found
+static double MeasureThroughput(const std::vector<PolygonPair>& pairs, int minVertices, std::vector<Contact>& contacts, std::vector<int>& counts)
+{
+	const int runs = 10;
+
+	contacts.resize(pairs.size() * MAX_CONTACTS_PER_PAIR);
+	counts.resize(pairs.size());
+	double bestMs = 1e30;
+	for (int run = 0; run < runs; run++)
+	{
+		Timer timer;
+		for (int i = 0; i < (int)pairs.size(); i++)
+		{
+			counts[i] = 0;
+			CollisionDetection::IsCollidingPolygonPolygon(pairs[i].a, pairs[i].b, &contacts[i * MAX_CONTACTS_PER_PAIR], counts[i], minVertices);
+		}
+		bestMs = std::min(bestMs, timer.ElapsedMs());
+	}
+	return pairs.size() / (bestMs * 1000.0);
+}
+
+static void RunPairs(const char* name, int numVertices, const std::vector<PolygonPair>& pairs)
+{
+	std::vector<Contact> allContacts, climbingContacts;
+	std::vector<int> allCounts, climbingCounts;
+	double allRate = MeasureThroughput(pairs, INT_MAX, allContacts, allCounts);
+	double climbingRate = MeasureThroughput(pairs, 0, climbingContacts, climbingCounts);
+
+	// Both find the same separations and reference edges, so the contacts of
+	// every pair should be bit for bit the same: count the pairs where they aren't
+	int numContacts = 0;
+	int numDifferent = 0;
+	for (int i = 0; i < (int)pairs.size(); i++)
+	{
+		numContacts += climbingCounts[i];
+		const Contact* all = &allContacts[i * MAX_CONTACTS_PER_PAIR];
+		const Contact* climbing = &climbingContacts[i * MAX_CONTACTS_PER_PAIR];
+		if (allCounts[i] != climbingCounts[i] || HashContacts(all, allCounts[i]) != HashContacts(climbing, climbingCounts[i]))
+		{
+			numDifferent++;
+		}
+	}
+
+	printf("%-12s %9d %8d %9d %14.2f %14.2f %8.2fx %10d\n", name, numVertices, (int)pairs.size(), numContacts,
+		allRate, climbingRate, climbingRate / allRate, numDifferent);
+}
+
+void BenchmarkHillClimbing()
+{
+	printf("Polygon pairs per microsecond, every edge against every vertex (all) or hill climbing (best of 10 runs)\n");
+	printf("%-12s %9s %8s %9s %14s %14s %9s %10s\n", "pairs", "vertices", "count", "contacts", "all", "climbing", "speedup", "different");
+
+	const int vertexCounts[] = { 3, 4, 6, 8, 12, 16, 32, 64 };
+	for (int numVertices : vertexCounts)
+	{
+		// Mostly overlapping
+		std::vector<PolygonPair> pairs;
+		World* world = CreatePolygonPairs(10000, numVertices, 20.0f, pairs);
+		RunPairs("overlapping", numVertices, pairs);
+		delete world;
+	}
+
+	for (int numVertices : vertexCounts)
+	{
+		// Farther apart, many of the pairs are separated
+		std::vector<PolygonPair> pairs;
+		World* world = CreatePolygonPairs(10000, numVertices, 50.0f, pairs);
+		RunPairs("near", numVertices, pairs);
+		delete world;
+	}
+}
@@ -0,0 +1,177 @@
+#include "Benchmark.h"
+#include "../src/Physics/Simd.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Same layout as Body before the motion state moved to BodyStore, every body
+// allocated on its own and integrated through a pointer
+struct AoSBody
+{
+	Vec2 position;
+	Vec2 velocity;
+	Vec2 acceleration;
+	float rotation;
+	float angularVelocity;
+	float angularAcceleration;
+	Vec2 sumForces;
+	float sumTorque;
+	float mass;
+	float invMass;
+	float I;
+	float invI;
+	float restitution;
+	float friction;
+	bool isAwake;
+	float sleepTime;
+	float linearSleepTolerance;
+	float angularSleepTolerance;
+	int index;
+	Shape* shape;
+	void* texture; // SDL_Texture*, which bodies don't keep anymore
+};
+
+static void IntegrateAoS(const std::vector<AoSBody*>& bodies, const Vec2& weight, float dt)
+{
+	for (auto body : bodies)
+	{
+		if (body->invMass == 0.0 || !body->isAwake)
+		{
+			continue;
+		}
+
+		body->sumForces += weight * body->mass;
+		body->acceleration = body->sumForces * body->invMass;
+		body->velocity += body->acceleration * dt;
+		body->angularAcceleration = body->sumTorque * body->invI;
+		body->angularVelocity += body->angularAcceleration * dt;
+		body->sumForces = Vec2(0.0, 0.0);
+		body->sumTorque = 0.0;
+	}
+
+	for (auto body : bodies)
+	{
+		if (body->invMass == 0.0 || !body->isAwake)
+		{
+			continue;
+		}
+
+		body->position += body->velocity * dt;
+		body->rotation += body->angularVelocity * dt;
+	}
+}
+
+void BenchmarkIntegration()
+{
+	const int numBodies = 100000;
+	const int steps = 200;
+	const float dt = 1.0f / 60.0f;
+	const Vec2 gravity = Vec2(0.0, 9.8 * 50);
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> coordinate(0.0, 1000.0);
+	std::uniform_real_distribution<float> speed(-50.0, 50.0);
+
+	std::vector<AoSBody*> aosBodies;
+	BodyStore store;
+	for (int i = 0; i < numBodies; i++)
+	{
+		BodyState state;
+		state.position = Vec2(coordinate(random), coordinate(random));
+		state.velocity = Vec2(speed(random), speed(random));
+		state.angularVelocity = speed(random) * 0.01;
+		state.invMass = 1.0;
+		state.invI = 1.0;
+
+		// A few static and sleeping bodies, which the kernels have to skip
+		if (i % 16 == 0)
+		{
+			state.invMass = 0.0;
+			state.invI = 0.0;
+		}
+		state.isAwake = i % 7 != 0;
+
+		// Some other allocation in between, like the shape of every body
+		AoSBody* body = new AoSBody();
+		body->position = state.position;
+		body->velocity = state.velocity;
+		body->angularVelocity = state.angularVelocity;
+		body->mass = state.invMass == 0.0 ? 0.0 : 1.0;
+		body->invMass = state.invMass;
+		body->I = body->mass;
+		body->invI = state.invI;
+		body->isAwake = state.isAwake;
+		body->shape = new CircleShape(1.0);
+		aosBodies.push_back(body);
+
+		store.Create(nullptr, state);
+	}
+
+	printf("%d bodies (1/16 static, 1/7 asleep), %d steps (forces + velocities, no vertex updates), best: %s\n", numBodies, steps, SimdLevelName(DetectSimdLevel()));
+	printf("%-24s %12s %14s %10s\n", "layout", "ms/step", "Mbodies/s", "result");
+
+	Timer timer;
+	for (int i = 0; i < steps; i++)
+	{
+		IntegrateAoS(aosBodies, gravity, dt);
+	}
+	double aosMs = timer.ElapsedMs() / steps;
+	printf("%-24s %12.3f %14.1f\n", "AoS (Body*)", aosMs, numBodies / aosMs / 1000.0);
+
+	// Every instruction set must give exactly the same result as the scalar kernels
+	BodyStore reference;
+	for (SimdLevel level : { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2 })
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "SoA %s", SimdLevelName(level));
+		if (level > DetectSimdLevel())
+		{
+			printf("%-24s %12s\n", name, "unsupported");
+			continue;
+		}
+
+		SetSimdLevel(level);
+		BodyStore soa = store;
+
+		timer.Reset();
+		for (int i = 0; i < steps; i++)
+		{
+			soa.IntegrateForces(0, soa.GetNumSlots(), gravity, Vec2(0.0, 0.0), 0.0, dt);
+			soa.IntegrateVelocities(0, soa.GetNumSlots(), dt);
+		}
+		double soaMs = timer.ElapsedMs() / steps;
+
+		bool identical = true;
+		if (level == SIMD_SCALAR)
+		{
+			reference = soa;
+
+			// The AoS path does the same math, it should end up in the same place too
+			float maxError = 0.0;
+			for (int i = 0; i < numBodies; i++)
+			{
+				maxError = std::max(maxError, (aosBodies[i]->position - soa.positions[i]).Magnitude());
+			}
+			identical = maxError == 0.0;
+		}
+		else
+		{
+			identical = memcmp(soa.positions.data(), reference.positions.data(), numBodies * sizeof(Vec2)) == 0 &&
+				memcmp(soa.velocities.data(), reference.velocities.data(), numBodies * sizeof(Vec2)) == 0 &&
+				memcmp(soa.rotations.data(), reference.rotations.data(), numBodies * sizeof(float)) == 0 &&
+				memcmp(soa.angularVelocities.data(), reference.angularVelocities.data(), numBodies * sizeof(float)) == 0;
+		}
+
+		printf("%-24s %12.3f %14.1f %10s\n", name, soaMs, numBodies / soaMs / 1000.0, identical ? "same" : "DIFFERENT");
+	}
+	SetSimdLevel(DetectSimdLevel());
+
+	for (auto body : aosBodies)
+	{
+		delete body->shape;
+		delete body;
+	}
+}
@@ -0,0 +1,49 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <thread>
+
+void BenchmarkIslands()
+{
+	const int numBoxes = 4000;
+	const int boxesPerColumn = 10;
+	const int settleSteps = 60;
+	const int steps = 120;
+	const float dt = 1.0f / 60.0f;
+	const int threadCounts[] = { 1, 2, 4, 8 };
+
+	printf("%d boxes in columns of %d (one island per column), %d steps, %u hardware threads\n", numBoxes, boxesPerColumn, steps, std::thread::hardware_concurrency());
+	printf("%8s %10s %9s %18s\n", "threads", "ms/step", "speedup", "state hash");
+
+	double serialMs = 0.0;
+	unsigned long long serialHash = 0;
+	for (int numThreads : threadCounts)
+	{
+		World* world = CreateBoxStacksScene(numBoxes, boxesPerColumn);
+		world->SetAllowSleeping(false); // every island has to be solved
+		world->SetNumThreads(numThreads);
+
+		for (int i = 0; i < settleSteps; i++)
+		{
+			world->Update(dt);
+		}
+
+		Timer timer;
+		for (int i = 0; i < steps; i++)
+		{
+			world->Update(dt);
+		}
+		double stepMs = timer.ElapsedMs() / steps;
+
+		unsigned long long hash = HashBodies(world);
+		if (numThreads == 1)
+		{
+			serialMs = stepMs;
+			serialHash = hash;
+		}
+
+		printf("%8d %10.3f %8.2fx %18llx %s\n", numThreads, stepMs, serialMs / stepMs, hash, hash == serialHash ? "" : "MISMATCH");
+
+		delete world;
+	}
+}
@@ -0,0 +1,62 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+struct BenchmarkEntry
+{
+	const char* name;
+	void (*run)();
+};
+
+static const BenchmarkEntry benchmarks[] = {
+	{ "broadphase", BenchmarkBroadphase },
+	{ "ballpit", BenchmarkBallPit },
+	{ "sap", BenchmarkSweepAndPrune },
+	{ "solver", BenchmarkSolver },
+	{ "stack", BenchmarkBoxStack },
+	{ "warmstart", BenchmarkWarmStart },
+	{ "sleep", BenchmarkSleep },
+	{ "islands", BenchmarkIslands },
+	{ "narrowphase", BenchmarkNarrowphase },
+	{ "coloring", BenchmarkColoring },
+	{ "integration", BenchmarkIntegration },
+	{ "widesolver", BenchmarkWideSolver },
+	{ "pools", BenchmarkPools },
+	{ "arena", BenchmarkFrameArena },
+	{ "dispatch", BenchmarkDispatch },
+	{ "boxbox", BenchmarkBoxBox },
+	{ "hillclimb", BenchmarkHillClimbing },
+	{ "scenes", BenchmarkScenes },
+};
+
+int main(int argc, char* argv[])
+{
+	// The engine logs every constructor/destructor call, keep the output readable
+	std::cout.setstate(std::ios_base::failbit);
+
+	bool found = false;
+	for (auto& benchmark : benchmarks)
+	{
+		if (argc < 2 || strcmp(argv[1], benchmark.name) == 0)
+		{
+			printf("=== %s ===\n", benchmark.name);
+			benchmark.run();
+			printf("\n");
+			found = true;
+		}
+	}
+
+	if (!found)
+	{
+		printf("Unknown benchmark: %s\nAvailable benchmarks:\n", argv[1]);
+		for (auto& benchmark : benchmarks)
+		{
+			printf("  %s\n", benchmark.name);
+		}
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+#include "../src/Physics/Narrowphase.h"
+
+#include <cstdio>
+#include <thread>
+
+static void RunScene(const char* name, World* world)
+{
+	const int settleSteps = 60;
+	const int repetitions = 50;
+	const float dt = 1.0f / 60.0f;
+	const int threadCounts[] = { 1, 2, 4, 8 };
+
+	world->SetAllowSleeping(false);
+	for (int i = 0; i < settleSteps; i++)
+	{
+		world->Update(dt);
+	}
+
+	// Find the pairs once, only the narrowphase is measured
+	std::vector<Body*>& bodies = world->GetBodies();
+	AABBTree broadphase;
+	for (int i = 0; i < (int)bodies.size(); i++)
+	{
+		broadphase.CreateProxy(i, bodies[i]->shape->GetAABB(bodies[i]->GetTransform()), bodies[i]->IsStatic());
+	}
+	std::vector<BroadphasePair> pairs;
+	broadphase.FindPairs(pairs);
+
+	double serialMs = 0.0;
+	unsigned long long serialHash = 0;
+	for (int numThreads : threadCounts)
+	{
+		JobSystem jobSystem(numThreads);
+		Narrowphase narrowphase;
+		FrameArena arena;
+		narrowphase.FindContacts(bodies, pairs, jobSystem, arena); // warm up the arena
+
+		Timer timer;
+		for (int i = 0; i < repetitions; i++)
+		{
+			arena.Reset();
+			narrowphase.FindContacts(bodies, pairs, jobSystem, arena);
+		}
+		double ms = timer.ElapsedMs() / repetitions;
+
+		int numContacts;
+		const Contact* contacts = narrowphase.GetContacts(numContacts);
+		unsigned long long hash = HashContacts(contacts, numContacts);
+		if (numThreads == 1)
+		{
+			serialMs = ms;
+			serialHash = hash;
+		}
+
+		printf("%-20s %8d %8d %9d %10.3f %8.2fx %18llx %s\n", name, numThreads, (int)pairs.size(), numContacts,
+			ms, serialMs / ms, hash, hash == serialHash ? "" : "MISMATCH");
+	}
+
+	delete world;
+}
+
+void BenchmarkNarrowphase()
+{
+	printf("%u hardware threads, narrowphase only (pairs from an AABB tree)\n", std::thread::hardware_concurrency());
+	printf("%-20s %8s %8s %9s %10s %9s %18s\n", "scene", "threads", "pairs", "contacts", "ms", "speedup", "contacts hash");
+
+	RunScene("ball pit 5000", CreateBallPitScene(5000));
+	RunScene("box stacks 4000", CreateBoxStacksScene(4000, 10));
+	RunScene("scattered 10000", CreateScatteredScene(10000));
+}
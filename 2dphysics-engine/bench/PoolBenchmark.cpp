@@ -0,0 +1,99 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Fires projectiles across a floor and removes them once they are old enough.
+// Counts the global allocations made by the spawn/despawn code per projectile
+// once the pools have grown to the peak number of live projectiles.
+static void RunProjectiles(const char* name, bool boxes)
+{
+	const int spawnsPerStep = 50;
+	const int lifetime = 60; // steps
+	const int warmupSteps = 120;
+	const int steps = 240;
+	const float dt = 1.0f / 60.0f;
+
+	World* world = new World(-9.8);
+	world->AddBody(new Body(BoxShape(8000, 50), 4000, 1000, 0.0));
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> height(100.0f, 900.0f);
+	std::uniform_real_distribution<float> speed(400.0f, 800.0f);
+
+	// Ring buffer of the live projectiles, oldest first
+	std::vector<Body*> projectiles(spawnsPerStep * lifetime, nullptr);
+	int next = 0;
+
+	long long spawnAllocations = 0;
+	long long stepAllocations = 0;
+	long long spawned = 0;
+	PoolStats bodyStart;
+	PoolStats shapeStart;
+	Timer timer;
+	for (int step = 0; step < warmupSteps + steps; step++)
+	{
+		if (step == warmupSteps)
+		{
+			spawnAllocations = 0;
+			stepAllocations = 0;
+			spawned = 0;
+			bodyStart = Body::GetPoolStats();
+			shapeStart = boxes ? BoxShape::GetPoolStats() : CircleShape::GetPoolStats();
+			timer.Reset();
+		}
+
+		long long before = GetAllocationCount();
+		for (int i = 0; i < spawnsPerStep; i++)
+		{
+			if (projectiles[next])
+			{
+				world->RemoveBody(projectiles[next]);
+			}
+
+			Body* projectile;
+			if (boxes)
+			{
+				projectile = new Body(BoxShape(12, 12), 0, height(random), 1.0);
+			}
+			else
+			{
+				projectile = new Body(CircleShape(6), 0, height(random), 1.0);
+			}
+			projectile->SetVelocity(Vec2(speed(random), -200.0f));
+			world->AddBody(projectile);
+
+			projectiles[next] = projectile;
+			next = (next + 1) % projectiles.size();
+			spawned++;
+		}
+		long long afterSpawn = GetAllocationCount();
+
+		world->Update(dt);
+
+		spawnAllocations += afterSpawn - before;
+		stepAllocations += GetAllocationCount() - afterSpawn;
+	}
+	double stepMs = timer.ElapsedMs() / steps;
+
+	const PoolStats& bodyStats = Body::GetPoolStats();
+	const PoolStats& shapeStats = boxes ? BoxShape::GetPoolStats() : CircleShape::GetPoolStats();
+	printf("%-12s %8.0f %8d %8.3f %12.2f %12.1f %8d %8d %10lld %10lld\n", name, spawned / (steps * dt), (int)world->GetBodies().size(), stepMs,
+		(double)spawnAllocations / spawned, (double)stepAllocations / steps,
+		bodyStats.chunks - bodyStart.chunks, shapeStats.chunks - shapeStart.chunks,
+		bodyStats.allocations - bodyStart.allocations, shapeStats.allocations - shapeStart.allocations);
+
+	delete world;
+}
+
+void BenchmarkPools()
+{
+	printf("projectiles fired across a floor (50 per step, removed after 60 steps), after %d warm up steps\n", 120);
+	printf("%-12s %8s %8s %8s %12s %12s %8s %8s %10s %10s\n", "projectiles", "spawns/s", "bodies", "ms/step", "allocs/spawn", "allocs/step",
+		"+body", "+shape", "body pool", "shape pool");
+	printf("%-12s %8s %8s %8s %12s %12s %8s %8s %10s %10s\n", "", "", "", "", "(global)", "(in Update)", "chunks", "chunks", "allocs", "allocs");
+
+	RunProjectiles("circles", false);
+	RunProjectiles("boxes", true);
+}
@@ -0,0 +1,136 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Results of one scene, written to the table, scenes.json and scenes.csv
+struct SceneResult
+{
+	std::string name;
+	int bodies;
+	int joints;
+	int steps;
+	double meanMs;
+	double p50Ms;
+	double p99Ms;
+	double maxMs;
+	double contactsPerStep;
+	int maxContacts;
+	double allocationsPerStep;
+	unsigned long long hash;
+};
+
+// Steps the world from its initial state (the scenes are built so that the
+// interesting part, bodies falling, piling up and settling, happens during
+// these steps) and times every step on its own
+static SceneResult RunScene(const char* name, World* world, int steps)
+{
+	const float dt = 1.0f / 60.0f;
+
+	SceneResult result;
+	result.name = name;
+	result.bodies = (int)world->GetBodies().size();
+	result.joints = (int)world->GetConstraints().size();
+	result.steps = steps;
+
+	std::vector<double> stepMs(steps);
+	long long numContacts = 0;
+	result.maxContacts = 0;
+	long long allocations = GetAllocationCount();
+	for (int i = 0; i < steps; i++)
+	{
+		Timer timer;
+		world->Update(dt);
+		stepMs[i] = timer.ElapsedMs();
+
+		numContacts += world->GetNumContacts();
+		result.maxContacts = std::max(result.maxContacts, world->GetNumContacts());
+	}
+	result.allocationsPerStep = (double)(GetAllocationCount() - allocations) / steps;
+	result.contactsPerStep = (double)numContacts / steps;
+
+	double totalMs = 0.0;
+	for (double ms : stepMs)
+	{
+		totalMs += ms;
+	}
+	std::sort(stepMs.begin(), stepMs.end());
+	result.meanMs = totalMs / steps;
+	result.p50Ms = stepMs[steps / 2];
+	result.p99Ms = stepMs[std::min(steps - 1, steps * 99 / 100)];
+	result.maxMs = stepMs[steps - 1];
+	result.hash = HashBodies(world);
+
+	delete world;
+	return result;
+}
+
+static void WriteJson(const char* fileName, const std::vector<SceneResult>& results)
+{
+	FILE* file = fopen(fileName, "w");
+	if (!file)
+	{
+		printf("Can't write %s\n", fileName);
+		return;
+	}
+
+	fprintf(file, "{\n  \"scenes\": [\n");
+	for (int i = 0; i < (int)results.size(); i++)
+	{
+		const SceneResult& r = results[i];
+		fprintf(file, "    {\"scene\": \"%s\", \"bodies\": %d, \"joints\": %d, \"steps\": %d, "
+			"\"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f, "
+			"\"contacts_per_step\": %.1f, \"max_contacts\": %d, \"allocations_per_step\": %.2f, \"state_hash\": \"%016llx\"}%s\n",
+			r.name.c_str(), r.bodies, r.joints, r.steps, r.meanMs, r.p50Ms, r.p99Ms, r.maxMs,
+			r.contactsPerStep, r.maxContacts, r.allocationsPerStep, r.hash, i + 1 < (int)results.size() ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+	fclose(file);
+}
+
+static void WriteCsv(const char* fileName, const std::vector<SceneResult>& results)
+{
+	FILE* file = fopen(fileName, "w");
+	if (!file)
+	{
+		printf("Can't write %s\n", fileName);
+		return;
+	}
+
+	fprintf(file, "scene,bodies,joints,steps,mean_ms,p50_ms,p99_ms,max_ms,contacts_per_step,max_contacts,allocations_per_step,state_hash\n");
+	for (auto& r : results)
+	{
+		fprintf(file, "%s,%d,%d,%d,%.4f,%.4f,%.4f,%.4f,%.1f,%d,%.2f,%016llx\n",
+			r.name.c_str(), r.bodies, r.joints, r.steps, r.meanMs, r.p50Ms, r.p99Ms, r.maxMs,
+			r.contactsPerStep, r.maxContacts, r.allocationsPerStep, r.hash);
+	}
+	fclose(file);
+}
+
+void BenchmarkScenes()
+{
+	const int steps = 600;
+
+	printf("World::Update() on the standard scenes, %d steps of 1/60 s from the initial state, 1 thread\n", steps);
+	printf("%-14s %7s %7s %9s %9s %9s %9s %10s %12s %18s\n", "scene", "bodies", "joints", "mean ms", "p50 ms", "p99 ms", "max ms", "contacts", "allocs/step", "state hash");
+
+	std::vector<SceneResult> results;
+	results.push_back(RunScene("pyramid", CreatePyramidScene(40), steps));
+	results.push_back(RunScene("ball pit", CreateBallPitScene(2000), steps));
+	results.push_back(RunScene("chains", CreateChainScene(20, 20), steps));
+	results.push_back(RunScene("mixed", CreateMixedPolygonsScene(1500), steps));
+	results.push_back(RunScene("towers", CreateTowerScene(8, 10), steps));
+
+	for (auto& r : results)
+	{
+		printf("%-14s %7d %7d %9.3f %9.3f %9.3f %9.3f %10.1f %12.2f   %016llx\n", r.name.c_str(), r.bodies, r.joints,
+			r.meanMs, r.p50Ms, r.p99Ms, r.maxMs, r.contactsPerStep, r.allocationsPerStep, r.hash);
+	}
+
+	// For scripts comparing two builds: same names, same order, one line per scene
+	WriteJson("scenes.json", results);
+	WriteCsv("scenes.csv", results);
+	printf("Written to scenes.json and scenes.csv\n");
+}
@@ -0,0 +1,273 @@
+#include "Benchmark.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+World* CreateScatteredScene(int numBodies)
+{
+	World* world = new World(-9.8);
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> jitter(-5.0f, 5.0f);
+	std::uniform_real_distribution<float> size(20.0f, 40.0f);
+	std::uniform_real_distribution<float> speed(-50.0f, 50.0f);
+
+	// Lay the bodies on a square grid, 45 pixels apart
+	const float spacing = 45.0f;
+	const int columns = (int)std::ceil(std::sqrt((float)numBodies));
+
+	for (int i = 0; i < numBodies; i++)
+	{
+		float x = (i % columns) * spacing + jitter(random);
+		float y = (i / columns) * spacing + jitter(random);
+
+		Body* body;
+		if (i % 2 == 0)
+		{
+			body = new Body(BoxShape(size(random), size(random)), x, y, 1.0);
+		}
+		else
+		{
+			body = new Body(CircleShape(size(random) / 2.0f), x, y, 1.0);
+		}
+		body->SetVelocity(Vec2(speed(random), speed(random)));
+
+		world->AddBody(body);
+	}
+
+	return world;
+}
+
+World* CreateBallPitScene(int numBalls)
+{
+	World* world = new World(-9.8);
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> radius(9.0f, 11.0f);
+
+	const int columns = 100;
+	const float spacing = 22.0f;
+	const int rows = (numBalls + columns - 1) / columns;
+	const float width = columns * spacing;
+	const float height = rows * spacing;
+
+	// Container (floor and walls)
+	world->AddBody(new Body(BoxShape(width + 100, 50), width / 2.0f, height + 25, 0.0));
+	world->AddBody(new Body(BoxShape(50, height + 100), -25, height / 2.0f, 0.0));
+	world->AddBody(new Body(BoxShape(50, height + 100), width + 25, height / 2.0f, 0.0));
+
+	for (int i = 0; i < numBalls; i++)
+	{
+		float x = (i % columns) * spacing + spacing / 2.0f;
+		float y = height - (i / columns) * spacing - spacing / 2.0f;
+
+		Body* ball = new Body(CircleShape(radius(random)), x, y, 1.0);
+		ball->restitution = 0.5;
+		ball->friction = 0.1;
+		world->AddBody(ball);
+	}
+
+	return world;
+}
+
+World* CreateBoxStacksScene(int numBoxes, int boxesPerColumn)
+{
+	World* world = new World(-9.8);
+
+	const float boxSize = 30.0f;
+	const float columnSpacing = 60.0f;
+	const int numColumns = (numBoxes + boxesPerColumn - 1) / boxesPerColumn;
+	const float width = numColumns * columnSpacing;
+	const float floorY = boxesPerColumn * boxSize + 25.0f;
+
+	world->AddBody(new Body(BoxShape(width + 100, 50), width / 2.0f, floorY, 0.0));
+
+	for (int i = 0; i < numBoxes; i++)
+	{
+		float x = (i / boxesPerColumn) * columnSpacing + columnSpacing / 2.0f;
+		float y = floorY - 25.0f - boxSize / 2.0f - (i % boxesPerColumn) * boxSize;
+
+		Body* box = new Body(BoxShape(boxSize, boxSize), x, y, 1.0);
+		box->restitution = 0.0;
+		box->friction = 0.7;
+		world->AddBody(box);
+	}
+
+	return world;
+}
+
+World* CreatePyramidScene(int numRows)
+{
+	World* world = new World(-9.8);
+
+	const float boxSize = 20.0f;
+	const float width = numRows * boxSize;
+	const float floorY = numRows * boxSize + 25.0f;
+
+	world->AddBody(new Body(BoxShape(width + 200, 50), width / 2.0f, floorY, 0.0));
+
+	// Every row has one box less than the one below and is shifted half a box
+	for (int row = 0; row < numRows; row++)
+	{
+		for (int i = 0; i < numRows - row; i++)
+		{
+			float x = row * boxSize / 2.0f + i * boxSize + boxSize / 2.0f;
+			float y = floorY - 25.0f - boxSize / 2.0f - row * boxSize;
+
+			Body* box = new Body(BoxShape(boxSize, boxSize), x, y, 1.0);
+			box->restitution = 0.0;
+			box->friction = 0.7;
+			world->AddBody(box);
+		}
+	}
+
+	return world;
+}
+
+World* CreateChainScene(int numChains, int linksPerChain)
+{
+	World* world = new World(-9.8);
+
+	const float radius = 8.0f;
+	const float linkSpacing = 20.0f;
+	const float chainSpacing = 40.0f;
+	const float chainLength = linksPerChain * linkSpacing;
+	const float floorY = numChains * linkSpacing + chainLength + 100.0f;
+	const float width = numChains * chainSpacing + chainLength;
+
+	world->AddBody(new Body(BoxShape(width + 100, 50), width / 2.0f, floorY, 0.0));
+
+	for (int chain = 0; chain < numChains; chain++)
+	{
+		// Every chain one link lower than the previous one, so they don't start overlapping
+		float x = chain * chainSpacing;
+		float y = chain * linkSpacing;
+
+		Body* anchor = new Body(CircleShape(radius), x, y, 0.0);
+		world->AddBody(anchor);
+
+		Body* previous = anchor;
+		for (int i = 1; i <= linksPerChain; i++)
+		{
+			Body* link = new Body(CircleShape(radius), x + i * linkSpacing, y, 1.0);
+			link->restitution = 0.0;
+			link->friction = 0.5;
+			world->AddBody(link);
+
+			// The joint is halfway between the two links
+			world->AddConstraint(new JointConstraint(previous, link, previous->GetPosition() + Vec2(linkSpacing / 2.0f, 0.0f)));
+			previous = link;
+		}
+	}
+
+	return world;
+}
+
+World* CreateMixedPolygonsScene(int numBodies)
+{
+	World* world = new World(-9.8);
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> size(10.0f, 18.0f);
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+	std::uniform_int_distribution<int> numVertices(3, 8);
+
+	const int columns = 60;
+	const float spacing = 40.0f;
+	const int rows = (numBodies + columns - 1) / columns;
+	const float width = columns * spacing;
+	const float height = rows * spacing;
+
+	world->AddBody(new Body(BoxShape(width + 100, 50), width / 2.0f, height + 25, 0.0));
+	world->AddBody(new Body(BoxShape(50, height + 100), -25, height / 2.0f, 0.0));
+	world->AddBody(new Body(BoxShape(50, height + 100), width + 25, height / 2.0f, 0.0));
+
+	for (int i = 0; i < numBodies; i++)
+	{
+		float x = (i % columns) * spacing + spacing / 2.0f;
+		float y = height - (i / columns) * spacing - spacing / 2.0f;
+
+		Body* body;
+		switch (i % 3)
+		{
+		case 0:
+			body = new Body(BoxShape(size(random) * 1.5f, size(random) * 1.5f), x, y, 1.0);
+			break;
+		case 1:
+			body = new Body(CircleShape(size(random)), x, y, 1.0);
+			break;
+		default:
+		{
+			// Regular polygon, with the winding of BoxShape
+			int n = numVertices(random);
+			float radius = size(random);
+			std::vector<Vec2> vertices;
+			for (int v = 0; v < n; v++)
+			{
+				float a = 2.0f * 3.14159265f * v / n;
+				vertices.push_back(Vec2(radius * std::cos(a), radius * std::sin(a)));
+			}
+			body = new Body(PolygonShape(vertices), x, y, 1.0);
+			break;
+		}
+		}
+		body->SetRotation(angle(random));
+		body->restitution = 0.2;
+		body->friction = 0.5;
+		world->AddBody(body);
+	}
+
+	return world;
+}
+
+World* CreateTowerScene(int numTowers, int floorsPerTower)
+{
+	World* world = new World(-9.8);
+
+	const float postWidth = 10.0f;
+	const float postHeight = 60.0f;
+	const float plankWidth = 80.0f;
+	const float plankHeight = 10.0f;
+	const float floorHeight = postHeight + plankHeight;
+	const float towerSpacing = 140.0f;
+	const float firstTowerX = 400.0f;
+	const float width = firstTowerX + numTowers * towerSpacing;
+	const float groundY = floorsPerTower * floorHeight + 25.0f;
+
+	// Ground and walls at both ends, the pieces that fly away stay in the scene
+	const float wallHeight = groundY + 400.0f;
+	world->AddBody(new Body(BoxShape(width + 200, 50), width / 2.0f, groundY, 0.0));
+	world->AddBody(new Body(BoxShape(50, wallHeight), -75, groundY - wallHeight / 2.0f, 0.0));
+	world->AddBody(new Body(BoxShape(50, wallHeight), width + 75, groundY - wallHeight / 2.0f, 0.0));
+
+	// Every floor: two posts and a plank resting on them
+	for (int tower = 0; tower < numTowers; tower++)
+	{
+		float x = firstTowerX + tower * towerSpacing;
+		for (int floor = 0; floor < floorsPerTower; floor++)
+		{
+			float bottom = groundY - 25.0f - floor * floorHeight;
+			for (float side : { -1.0f, 1.0f })
+			{
+				Body* post = new Body(BoxShape(postWidth, postHeight), x + side * (plankWidth - postWidth) / 2.0f, bottom - postHeight / 2.0f, 1.0);
+				post->restitution = 0.0;
+				post->friction = 0.7;
+				world->AddBody(post);
+			}
+
+			Body* plank = new Body(BoxShape(plankWidth, plankHeight), x, bottom - postHeight - plankHeight / 2.0f, 1.0);
+			plank->restitution = 0.0;
+			plank->friction = 0.7;
+			world->AddBody(plank);
+		}
+	}
+
+	// The projectile, heavy and fast, aimed at the middle of the first tower
+	Body* ball = new Body(CircleShape(20), 50.0f, groundY - 25.0f - floorsPerTower * floorHeight / 2.0f, 20.0);
+	ball->SetVelocity(Vec2(800.0f, -100.0f));
+	ball->restitution = 0.3;
+	world->AddBody(ball);
+
+	return world;
+}
@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+void BenchmarkSleep()
+{
+	const int numBoxes = 5000;
+	const int boxesPerColumn = 10;
+	const int settleSteps = 120;
+	const int steps = 120;
+	const float dt = 1.0f / 60.0f;
+
+	printf("%d boxes in columns of %d, %d steps after settling for %d steps\n", numBoxes, boxesPerColumn, steps, settleSteps);
+	printf("%-10s %12s %12s %8s %8s %10s\n", "sleeping", "settle ms", "ms/step", "awake", "asleep", "islands");
+
+	for (bool allowSleeping : { false, true })
+	{
+		World* world = CreateBoxStacksScene(numBoxes, boxesPerColumn);
+		world->SetAllowSleeping(allowSleeping);
+
+		Timer timer;
+		for (int i = 0; i < settleSteps; i++)
+		{
+			world->Update(dt);
+		}
+		double settleMs = timer.ElapsedMs() / settleSteps;
+
+		timer.Reset();
+		for (int i = 0; i < steps; i++)
+		{
+			world->Update(dt);
+		}
+		double stepMs = timer.ElapsedMs() / steps;
+
+		const IslandStats& stats = world->GetIslandStats();
+		printf("%-10s %12.3f %12.3f %8d %8d %10d\n", allowSleeping ? "on" : "off", settleMs, stepMs, stats.awakeBodies, stats.sleepingBodies, stats.islands);
+
+		if (allowSleeping)
+		{
+			// Moving a sleeping box by hand (or pushing it) must wake it up: it
+			// falls back onto its column instead of hanging in the air
+			std::vector<Body*>& bodies = world->GetBodies();
+			Body* moved = bodies[bodies.size() - 1];
+			Body* pushed = bodies[bodies.size() - 1 - boxesPerColumn];
+			bool wasAsleep = !moved->IsAwake() && !pushed->IsAwake();
+
+			const float startY = moved->GetPosition().y - 200.0f;
+			moved->SetPosition(Vec2(moved->GetPosition().x, startY));
+			moved->SetVelocity(Vec2(0.0f, 50.0f));
+			pushed->AddForce(Vec2(0.0f, -100.0f));
+			bool pushedAwake = pushed->IsAwake();
+
+			for (int i = 0; i < 60; i++)
+			{
+				world->Update(dt);
+			}
+			float fallen = moved->GetPosition().y - startY;
+			bool ok = wasAsleep && pushedAwake && fallen > 100.0f;
+			printf("waking by hand: %s (fell %.1f px in 60 steps)\n", ok ? "ok" : "FAILED", fallen);
+		}
+
+		delete world;
+	}
+}
@@ -0,0 +1,78 @@
+#include "Benchmark.h"
+#include "../src/Physics/MatMN.h"
+
+#include <cstdio>
+
+// The heap based math Solve() used before the fixed size Mat/Vec, kept here as a reference
+static void SolveWithMatMN(const Constraint& constraint, const MatMN& J)
+{
+	MatMN invM(6, 6);
+	invM.Zero();
+	invM.rows[0][0] = constraint.a->GetInvMass();
+	invM.rows[1][1] = constraint.a->GetInvMass();
+	invM.rows[2][2] = constraint.a->GetInvI();
+	invM.rows[3][3] = constraint.b->GetInvMass();
+	invM.rows[4][4] = constraint.b->GetInvMass();
+	invM.rows[5][5] = constraint.b->GetInvI();
+
+	VecN V(6);
+	V[0] = constraint.a->GetVelocity().x;
+	V[1] = constraint.a->GetVelocity().y;
+	V[2] = constraint.a->GetAngularVelocity();
+	V[3] = constraint.b->GetVelocity().x;
+	V[4] = constraint.b->GetVelocity().y;
+	V[5] = constraint.b->GetAngularVelocity();
+
+	const MatMN Jt = J.Transpose();
+	MatMN lhs = J * invM * Jt;
+	VecN rhs = J * V * -1.0f;
+	VecN lambda = MatMN::SolveGaussSeidel(lhs, rhs);
+	VecN impulses = Jt * lambda;
+
+	constraint.a->ApplyImpulseLinear(Vec2(impulses[0], impulses[1]));
+	constraint.a->ApplyImpulseAngular(impulses[2]);
+	constraint.b->ApplyImpulseLinear(Vec2(impulses[3], impulses[4]));
+	constraint.b->ApplyImpulseAngular(impulses[5]);
+}
+
+template <typename T>
+static void Measure(const char* name, int iterations, T solve)
+{
+	long long allocationsBefore = GetAllocationCount();
+	Timer timer;
+	for (int i = 0; i < iterations; i++)
+	{
+		solve();
+	}
+	double ms = timer.ElapsedMs();
+	long long allocations = GetAllocationCount() - allocationsBefore;
+
+	printf("%-28s | %12.1f %16.2f\n", name, ms * 1000000.0 / iterations, (double)allocations / iterations);
+}
+
+void BenchmarkSolver()
+{
+	const int iterations = 1000000;
+	const float dt = 1.0f / 60.0f;
+
+	Body a(BoxShape(50, 50), 100, 100, 1.0);
+	Body b(BoxShape(50, 50), 140, 100, 1.0);
+	a.SetVelocity(Vec2(10, 0));
+	b.SetVelocity(Vec2(-10, 0));
+
+	JointConstraint joint(&a, &b, Vec2(120, 100));
+	PenetrationConstraint penetration(&a, &b, Vec2(115, 100), Vec2(125, 100), Vec2(1, 0));
+	joint.PreSolve(dt);
+	penetration.PreSolve(dt);
+
+	MatMN J1(1, 6);
+	J1.Zero();
+	MatMN J2(2, 6);
+	J2.Zero();
+
+	printf("%-28s | %12s %16s\n", "solve", "ns/Solve()", "allocs/Solve()");
+	Measure("JointConstraint", iterations, [&]() { joint.Solve(); });
+	Measure("PenetrationConstraint", iterations, [&]() { penetration.Solve(); });
+	Measure("MatMN reference (1x6)", iterations, [&]() { SolveWithMatMN(joint, J1); });
+	Measure("MatMN reference (2x6)", iterations, [&]() { SolveWithMatMN(penetration, J2); });
+}
@@ -0,0 +1,47 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+void BenchmarkSweepAndPrune()
+{
+	const int numBoxes = 1000;
+	const int boxesPerColumn = 10;
+	const int settleSteps = 60;
+	const int steps = 30;
+	const float dt = 1.0f / 60.0f;
+	const BroadphaseType types[] = { AABB_TREE, SPATIAL_HASH, SWEEP_AND_PRUNE };
+
+	printf("%d boxes in columns of %d, %d settle steps then %d measured steps\n", numBoxes, boxesPerColumn, settleSteps, steps);
+	printf("%-16s | %12s %12s %14s %10s\n", "broadphase", "pairs/step", "swaps/step", "AABB tests", "step ms");
+
+	for (BroadphaseType type : types)
+	{
+		World* world = CreateBoxStacksScene(numBoxes, boxesPerColumn);
+		world->SetBroadphase(CreateBroadphase(type));
+		world->SetAllowSleeping(false); // compare the broadphases with every body awake
+
+		for (int i = 0; i < settleSteps; i++)
+		{
+			world->Update(dt);
+		}
+
+		long long pairs = 0;
+		long long swaps = 0;
+		long long tests = 0;
+		Timer timer;
+		for (int i = 0; i < steps; i++)
+		{
+			world->Update(dt);
+
+			const BroadphaseStats& stats = world->GetBroadphase()->GetStats();
+			pairs += stats.pairs;
+			swaps += stats.sortSwaps;
+			tests += stats.overlapTests;
+		}
+		double stepMs = timer.ElapsedMs() / steps;
+
+		printf("%-16s | %12lld %12lld %14lld %10.2f\n", BroadphaseName(type), pairs / steps, swaps / steps, tests / steps, stepMs);
+
+		delete world;
+	}
+}
@@ -0,0 +1,58 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// Steps the box stacks and returns how far (in pixels) the box that moved
+// the most ended up from its starting position
+static float RunBoxStacks(bool warmStarting, int iterations, int steps, double& stepMs)
+{
+	const float dt = 1.0f / 60.0f;
+
+	World* world = CreateBoxStacksScene(500, 5);
+	world->SetWarmStarting(warmStarting);
+	world->SetSolverIterations(iterations);
+	world->SetAllowSleeping(false); // measure the solver, not the sleeping
+
+	std::vector<Vec2> startPositions;
+	for (auto body : world->GetBodies())
+	{
+		startPositions.push_back(body->GetPosition());
+	}
+
+	Timer timer;
+	for (int i = 0; i < steps; i++)
+	{
+		world->Update(dt);
+	}
+	stepMs = timer.ElapsedMs() / steps;
+
+	float maxDrift = 0.0f;
+	for (int i = 0; i < (int)world->GetBodies().size(); i++)
+	{
+		maxDrift = std::max(maxDrift, (world->GetBodies()[i]->GetPosition() - startPositions[i]).Magnitude());
+	}
+
+	delete world;
+	return maxDrift;
+}
+
+void BenchmarkWarmStart()
+{
+	const int iterations[] = { 2, 4, 6, 9 };
+	const int steps = 600;
+
+	printf("500 boxes in columns of 5, %d steps\n", steps);
+	printf("%-12s %10s %12s %14s\n", "warm start", "iterations", "ms/step", "max drift px");
+
+	for (bool warmStarting : { false, true })
+	{
+		for (int count : iterations)
+		{
+			double stepMs;
+			float drift = RunBoxStacks(warmStarting, count, steps, stepMs);
+			printf("%-12s %10d %12.3f %14.2f\n", warmStarting ? "on" : "off", count, stepMs, drift);
+		}
+	}
+}
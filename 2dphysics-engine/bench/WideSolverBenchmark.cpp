@@ -0,0 +1,89 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+struct WideRun
+{
+	double stepMs;
+	unsigned long long hash;
+	std::vector<Vec2> positions;
+};
+
+static WideRun RunPyramid(int numRows, int iterations, bool graphColoring, bool wide, SimdLevel level, int steps)
+{
+	const float dt = 1.0f / 60.0f;
+
+	SetSimdLevel(level);
+	World* world = CreatePyramidScene(numRows);
+	world->SetAllowSleeping(false);
+	world->SetSolverIterations(iterations);
+	world->SetGraphColoring(graphColoring);
+	world->SetWideContactSolver(wide);
+
+	Timer timer;
+	for (int i = 0; i < steps; i++)
+	{
+		world->Update(dt);
+	}
+
+	WideRun run;
+	run.stepMs = timer.ElapsedMs() / steps;
+	run.hash = HashBodies(world);
+	for (auto body : world->GetBodies())
+	{
+		run.positions.push_back(body->GetPosition());
+	}
+
+	delete world;
+	SetSimdLevel(DetectSimdLevel());
+	return run;
+}
+
+static float MaxDifference(const WideRun& a, const WideRun& b)
+{
+	float maxDifference = 0.0;
+	for (int i = 0; i < (int)a.positions.size(); i++)
+	{
+		maxDifference = std::max(maxDifference, (a.positions[i] - b.positions[i]).Magnitude());
+	}
+	return maxDifference;
+}
+
+void BenchmarkWideSolver()
+{
+	const int numRows = 100; // 5050 boxes
+	const int steps = 60;
+	const int iterationCounts[] = { 8, 32 };
+
+	printf("pyramid of %d rows (%d boxes, one colored island), %d steps, 1 thread, best: %s\n", numRows, numRows * (numRows + 1) / 2, steps, SimdLevelName(DetectSimdLevel()));
+	printf("%-22s %6s %10s %9s %16s %18s\n", "solver", "iters", "ms/step", "speedup", "max diff px", "state hash");
+
+	for (int iterations : iterationCounts)
+	{
+		// The scalar solver on the same colors is the reference, the wide one must match it exactly
+		WideRun reference = RunPyramid(numRows, iterations, true, false, SIMD_SCALAR, steps);
+		printf("%-22s %6d %10.3f %8.2fx %16g %18llx\n", "colored scalar", iterations, reference.stepMs, 1.0, 0.0, reference.hash);
+
+		for (SimdLevel level : { SIMD_SSE2, SIMD_AVX2 })
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "colored wide %s", SimdLevelName(level));
+			if (level > DetectSimdLevel())
+			{
+				printf("%-22s %6d %10s\n", name, iterations, "unsupported");
+				continue;
+			}
+
+			WideRun run = RunPyramid(numRows, iterations, true, true, level, steps);
+			printf("%-22s %6d %10.3f %8.2fx %16g %18llx %s\n", name, iterations, run.stepMs, reference.stepMs / run.stepMs,
+				MaxDifference(run, reference), run.hash, run.hash == reference.hash ? "" : "MISMATCH");
+		}
+
+		// The serial Gauss-Seidel order of an uncolored island gives a slightly different (but as valid) answer
+		WideRun serial = RunPyramid(numRows, iterations, false, false, SIMD_SCALAR, steps);
+		printf("%-22s %6d %10.3f %8.2fx %16g %18llx\n", "serial (uncolored)", iterations, serial.stepMs, reference.stepMs / serial.stepMs,
+			MaxDifference(serial, reference), serial.hash);
+	}
+}
@@ -0,0 +1,150 @@
+// impact-sim: steps a scene without a window and reports how long it took.
+// Only needs the physics library, so it runs on machines without SDL.
+//
+//   impact-sim <scene> [steps] [bodies] [threads] [trace.json]
+
+#include "../bench/Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+struct SceneEntry
+{
+	const char* name;
+	World* (*create)(int numBodies);
+};
+
+static World* CreateBoxStacks(int numBodies)
+{
+	return CreateBoxStacksScene(numBodies, 10);
+}
+
+// The biggest pyramid with at most "numBodies" boxes
+static World* CreatePyramid(int numBodies)
+{
+	int numRows = (int)((std::sqrt(8.0 * numBodies + 1.0) - 1.0) / 2.0);
+	return CreatePyramidScene(std::max(numRows, 1));
+}
+
+// Chains of 20 links
+static World* CreateChains(int numBodies)
+{
+	return CreateChainScene(std::max(numBodies / 20, 1), 20);
+}
+
+// Towers of 10 floors, 3 boxes per floor
+static World* CreateTowers(int numBodies)
+{
+	return CreateTowerScene(std::max(numBodies / 30, 1), 10);
+}
+
+static const SceneEntry scenes[] = {
+	{ "scattered", CreateScatteredScene },
+	{ "ballpit", CreateBallPitScene },
+	{ "stacks", CreateBoxStacks },
+	{ "pyramid", CreatePyramid },
+	{ "chains", CreateChains },
+	{ "mixed", CreateMixedPolygonsScene },
+	{ "towers", CreateTowers },
+};
+
+int main(int argc, char* argv[])
+{
+	// The engine logs every constructor/destructor call, keep the output readable
+	std::cout.setstate(std::ios_base::failbit);
+
+	const SceneEntry* scene = nullptr;
+	for (auto& entry : scenes)
+	{
+		if (argc >= 2 && strcmp(argv[1], entry.name) == 0)
+		{
+			scene = &entry;
+		}
+	}
+
+	if (!scene)
+	{
+		printf("Usage: %s <scene> [steps] [bodies] [threads] [trace.json]\nAvailable scenes:\n", argv[0]);
+		for (auto& entry : scenes)
+		{
+			printf("  %s\n", entry.name);
+		}
+		return 1;
+	}
+
+	const int steps = argc >= 3 ? atoi(argv[2]) : 1000;
+	const int numBodies = argc >= 4 ? atoi(argv[3]) : 5000;
+	const int numThreads = argc >= 5 ? atoi(argv[4]) : 1;
+	const char* traceFileName = argc >= 6 ? argv[5] : nullptr;
+	const float dt = 1.0f / 60.0f;
+
+	World* world = scene->create(numBodies);
+	world->SetNumThreads(numThreads);
+	world->SetTracing(traceFileName != nullptr);
+
+	double totalMs = 0.0;
+	double minMs = 1e30;
+	double maxMs = 0.0;
+	double phaseMs[NUM_STEP_PHASES] = {};
+	long long numPairs = 0, numContacts = 0, numConstraints = 0;
+	for (int i = 0; i < steps; i++)
+	{
+		Timer timer;
+		world->Update(dt);
+		double stepMs = timer.ElapsedMs();
+
+		totalMs += stepMs;
+		minMs = std::min(minMs, stepMs);
+		maxMs = std::max(maxMs, stepMs);
+
+		const StepStats& stats = world->GetStepStats();
+		for (int phase = 0; phase < NUM_STEP_PHASES; phase++)
+		{
+			phaseMs[phase] += stats.phaseMs[phase];
+		}
+		numPairs += stats.pairs;
+		numContacts += stats.contacts;
+		numConstraints += stats.constraints;
+	}
+
+	const IslandStats& stats = world->GetIslandStats();
+	printf("scene        %s\n", scene->name);
+	printf("bodies       %d (%d awake, %d asleep)\n", (int)world->GetBodies().size(), stats.awakeBodies, stats.sleepingBodies);
+	printf("steps        %d of %.4f s, %d threads\n", steps, dt, numThreads);
+	printf("total        %.3f ms\n", totalMs);
+	printf("ms/step      %.3f mean, %.3f min, %.3f max\n", steps > 0 ? totalMs / steps : 0.0, steps > 0 ? minMs : 0.0, maxMs);
+	printf("steps/s      %.1f\n", totalMs > 0.0 ? steps * 1000.0 / totalMs : 0.0);
+	printf("state hash   %016llx\n", HashBodies(world));
+
+	if (steps > 0)
+	{
+		printf("per step     %.1f pairs, %.1f contacts, %.1f constraints solved\n",
+			(double)numPairs / steps, (double)numContacts / steps, (double)numConstraints / steps);
+#if IMPACT_PROFILING
+		printf("phases       mean ms/step\n");
+		for (int phase = 0; phase < NUM_STEP_PHASES; phase++)
+		{
+			printf("  %-22s %8.3f\n", StepPhaseName((StepPhase)phase), phaseMs[phase] / steps);
+		}
+#endif
+	}
+
+	if (traceFileName)
+	{
+		if (world->WriteTrace(traceFileName))
+		{
+			printf("trace        %s\n", traceFileName);
+		}
+		else
+		{
+			printf("Can't write %s\n", traceFileName);
+		}
+	}
+
+	delete world;
+	return 0;
+}
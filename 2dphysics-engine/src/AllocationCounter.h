@@ -0,0 +1,9 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+// Number of heap allocations (global operator new) since the program started.
+// Only counted by the programs that link AllocationCounter.cpp: the app and
+// the benchmarks, never the physics library
+long long GetAllocationCount();
+
+#endif
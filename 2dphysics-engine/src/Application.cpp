@@ -1,15 +1,107 @@
 #include "Application.h"
 
-#include "./Physics/Constants.h"
+#include "./AllocationCounter.h"
+
 #include "./Physics/Force.h"
 #include "./Physics/CollisionDetection.h"
 #include "./Physics/Contact.h"
 
+#include <SDL_image.h>
+#include <cmath>
+#include <iostream>
+
 bool Application::IsRunning()
 {
     return running;
 }
 
+void Application::SetPhysicsRate(int stepsPerSecond)
+{
+    this->stepsPerSecond = stepsPerSecond;
+}
+
+void Application::SetRenderRate(int framesPerSecond)
+{
+    this->framesPerSecond = framesPerSecond;
+}
+
+void Application::SavePreviousStates()
+{
+    const std::vector<Body*>& bodies = world->GetBodies();
+    previousStates.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        previousStates[i] = { bodies[i]->GetHandle(), bodies[i]->GetPosition(), bodies[i]->GetRotation() };
+    }
+}
+
+void Application::GetRenderState(int index, const Body* body, Vec2& position, float& rotation) const
+{
+    position = body->GetPosition();
+    rotation = body->GetRotation();
+
+    // Bodies added since the last step are drawn where they are, even in the
+    // slot of a removed body (it has another generation)
+    if (index >= (int)previousStates.size())
+    {
+        return;
+    }
+    const BodyState& previous = previousStates[index];
+    const BodyHandle handle = body->GetHandle();
+    if (previous.handle.index != handle.index || previous.handle.generation != handle.generation)
+    {
+        return;
+    }
+    position = previous.position + (position - previous.position) * interpolation;
+    rotation = previous.rotation + (rotation - previous.rotation) * interpolation;
+}
+
+SDL_Texture* Application::LoadTexture(const std::string& textureFileName)
+{
+    auto loaded = textures.find(textureFileName);
+    if (loaded != textures.end())
+    {
+        return loaded->second;
+    }
+
+    // Load the file from "textureFileName" as an SDL_Texture
+    SDL_Texture* texture = nullptr;
+    SDL_Surface* surface = IMG_Load(textureFileName.c_str());
+    if (surface)
+    {
+        texture = SDL_CreateTextureFromSurface(Graphics::renderer, surface);
+        SDL_FreeSurface(surface);
+    }
+    else
+    {
+        std::cerr << "Error loading texture: " << textureFileName << std::endl;
+    }
+
+    // Failures are remembered too, the file isn't loaded again for every body
+    textures[textureFileName] = texture;
+    return texture;
+}
+
+void Application::SetTexture(const Body* body, const char* textureFileName)
+{
+    BodyHandle handle = body->GetHandle();
+    if (handle.index >= (int)bodyTextures.size())
+    {
+        bodyTextures.resize(handle.index + 1, { -1, nullptr });
+    }
+    bodyTextures[handle.index] = { handle.generation, LoadTexture(textureFileName) };
+}
+
+SDL_Texture* Application::GetTexture(const Body* body) const
+{
+    BodyHandle handle = body->GetHandle();
+    if (handle.index < 0 || handle.index >= (int)bodyTextures.size() || bodyTextures[handle.index].generation != handle.generation)
+    {
+        return nullptr;
+    }
+    return bodyTextures[handle.index].texture;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Setup function (executed once in the beginning of the simulation)
 ///////////////////////////////////////////////////////////////////////////////
@@ -27,20 +119,20 @@ void Application::Setup()
     floor->restitution = 0.8;
     leftWall->restitution = 0.2;
     rightWall->restitution = 0.2;
-    floor->SetTexture("./assets/metal.png");
-    leftWall->SetTexture("./assets/metal.png");
-    rightWall->SetTexture("./assets/metal.png");
     world->AddBody(floor);
     world->AddBody(leftWall);
     world->AddBody(rightWall);
+    SetTexture(floor, "./assets/metal.png");
+    SetTexture(leftWall, "./assets/metal.png");
+    SetTexture(rightWall, "./assets/metal.png");
 
     /*// Add a static box so other objects can collide
     Body* bigBox = new Body(BoxShape(200, 200), Graphics::Width() / 2.0, Graphics::Height() / 2.0, 0.0);
-    bigBox->SetTexture("./assets/crate.png");
     bigBox->restitution = 0.7;
-    bigBox->rotation = 1.4;
-    bigBox->shape->UpdateVertices(bigBox->rotation, bigBox->position);
-    world->AddBody(bigBox);*/
+    bigBox->SetRotation(1.4);
+    bigBox->shape->UpdateVertices(bigBox->GetTransform());
+    world->AddBody(bigBox);
+    SetTexture(bigBox, "./assets/crate.png");*/
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -57,8 +149,32 @@ void Application::Input()
         case SDL_KEYDOWN:
             if (event.key.keysym.sym == SDLK_ESCAPE)
                 running = false;
+            // Wireframes and the performance HUD
             if (event.key.keysym.sym == SDLK_d)
                 debug = !debug;
+            if (event.key.keysym.sym == SDLK_b)
+            {
+                // Cycle between the broadphase implementations to compare them
+                switch (world->GetBroadphase()->GetType())
+                {
+                case ALL_PAIRS:
+                    world->SetBroadphase(new AABBTree());
+                    std::cout << "Broadphase: AABB tree" << std::endl;
+                    break;
+                case AABB_TREE:
+                    world->SetBroadphase(new SpatialHash());
+                    std::cout << "Broadphase: spatial hash" << std::endl;
+                    break;
+                case SPATIAL_HASH:
+                    world->SetBroadphase(new SweepAndPrune());
+                    std::cout << "Broadphase: sweep and prune" << std::endl;
+                    break;
+                default:
+                    world->SetBroadphase(new AllPairs());
+                    std::cout << "Broadphase: all pairs" << std::endl;
+                    break;
+                }
+            }
             break;
         case SDL_MOUSEBUTTONDOWN:
             if (event.button.button == SDL_BUTTON_LEFT)
@@ -67,11 +183,11 @@ void Application::Input()
                 SDL_GetMouseState(&x, &y);
 
                 Body* ball = new Body(CircleShape(30), x, y, 0.62);
-                ball->SetTexture("./assets/basketball.png");
                 ball->restitution = 0.75;
                 ball->friction = 0.1;
 
                 world->AddBody(ball);
+                SetTexture(ball, "./assets/basketball.png");
             }
 
             if (event.button.button == SDL_BUTTON_RIGHT)
@@ -80,11 +196,11 @@ void Application::Input()
                 SDL_GetMouseState(&x, &y);
 
                 Body* tennisBall = new Body(CircleShape(15), x, y, 0.058);
-                tennisBall->SetTexture("./assets/tennisball.png");
                 tennisBall->restitution = 0.85;
                 tennisBall->friction = 0.1;
 
                 world->AddBody(tennisBall);
+                SetTexture(tennisBall, "./assets/tennisball.png");
             }
 
             if (event.button.button == SDL_BUTTON_MIDDLE)
@@ -93,17 +209,17 @@ void Application::Input()
                 SDL_GetMouseState(&x, &y);
 
                 Body* ball = new Body(CircleShape(30), Graphics::Width() / 2.0, 100, 0.62);
-                ball->SetTexture("./assets/basketball.png");
                 ball->restitution = 0.75;
                 ball->friction = 0.1;
 
                 Body* tennisBall = new Body(CircleShape(15), Graphics::Width() / 2.0 + 0.05, 50, 0.058);
-                tennisBall->SetTexture("./assets/tennisball.png");
                 tennisBall->restitution = 0.85;
                 tennisBall->friction = 0.1;
 
                 world->AddBody(ball);
                 world->AddBody(tennisBall);
+                SetTexture(ball, "./assets/basketball.png");
+                SetTexture(tennisBall, "./assets/tennisball.png");
             }
 
             break;
@@ -118,23 +234,48 @@ void Application::Update()
 {
     Graphics::ClearScreen(0xFF0F0721);
 
-    // Wait some time until the target frame time in milliseconds is reached
-    static int timePreviousFrame;
-    int timeToWait = MILLISECS_PER_FRAME - (SDL_GetTicks() - timePreviousFrame);
-    if (timeToWait > 0)
-        SDL_Delay(timeToWait);
-
-    // Calculate the deltatime in seconds
-    float deltaTime = (SDL_GetTicks() - timePreviousFrame) / 1000.0f;
-    if (deltaTime > 0.016) {
-        deltaTime = 0.016;
+    // Limit the frame rate. It only decides how often the bodies are drawn,
+    // the physics runs at its own rate
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    if (framesPerSecond > 0 && counterPreviousFrame)
+    {
+        double elapsedMs = (SDL_GetPerformanceCounter() - counterPreviousFrame) * 1000.0 / frequency;
+        int timeToWait = (int)(1000.0 / framesPerSecond - elapsedMs);
+        if (timeToWait > 0)
+            SDL_Delay(timeToWait);
     }
 
-    // Set  the time of the current frame to be used in the next one
-    timePreviousFrame = SDL_GetTicks();
+    // Time of the whole frame (the rendering and the waiting included) in seconds
+    Uint64 counter = SDL_GetPerformanceCounter();
+    float frameTime = counterPreviousFrame ? (counter - counterPreviousFrame) / (double)frequency : 0.0;
+    counterPreviousFrame = counter;
 
     // Update world bodies (integration, collision detection & resolution, etc.)
-    world->Update(deltaTime);
+    // with fixed steps, so a run doesn't depend on the frame rate
+    const float deltaTime = 1.0f / stepsPerSecond;
+    accumulator += frameTime;
+    int steps = 0;
+    while (accumulator >= deltaTime && steps < MAX_STEPS_PER_FRAME)
+    {
+        SavePreviousStates();
+        world->Update(deltaTime);
+        hud.AddStep(world);
+        accumulator -= deltaTime;
+        steps++;
+    }
+
+    // Stepping can't keep up (or the window was dragged): the simulation
+    // slows down instead of running more steps every frame
+    if (accumulator >= deltaTime)
+    {
+        accumulator = std::fmod(accumulator, deltaTime);
+    }
+    interpolation = accumulator / deltaTime;
+
+    // Heap allocations since the previous frame, for the HUD
+    long long allocations = GetAllocationCount();
+    hud.AddFrame(world, frameTime * 1000.0f, allocations - allocationsPreviousFrame);
+    allocationsPreviousFrame = allocations;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -142,47 +283,67 @@ void Application::Update()
 ///////////////////////////////////////////////////////////////////////////////
 void Application::Render()
 {
-    // Draw all bodies
-    for (auto& body : world->GetBodies()) 
+    // Draw all bodies, between their last two steps
+    const std::vector<Body*>& bodies = world->GetBodies();
+    for (int i = 0; i < (int)bodies.size(); i++) 
     {
+        Body* body = bodies[i];
+        Vec2 position;
+        float rotation;
+        GetRenderState(i, body, position, rotation);
+        Transform transform(position, Rotation(rotation));
+
+        // In debug mode the sleeping bodies are drawn in gray
+        Uint32 color = body->IsAwake() ? 0xFF0000FF : 0xFF808080;
+        SDL_Texture* texture = GetTexture(body);
+
         if (body->shape->GetType() == CIRCLE) 
         {
             CircleShape* circleShape = (CircleShape*)body->shape;
-            if (!debug && body->texture) 
+            if (!debug && texture) 
             {
-                Graphics::DrawTexture(body->position.x, body->position.y, circleShape->radius * 2, circleShape->radius * 2, body->rotation, body->texture);
+                Graphics::DrawTexture(position.x, position.y, circleShape->radius * 2, circleShape->radius * 2, rotation, texture);
             }
             else if (debug) 
             {
-                Graphics::DrawCircle(body->position.x, body->position.y, circleShape->radius, body->rotation, 0xFF0000FF);
+                Graphics::DrawCircle(position.x, position.y, circleShape->radius, rotation, color);
             }
         }
         if (body->shape->GetType() == BOX) 
         {
             BoxShape* boxShape = (BoxShape*)body->shape;
-            if (!debug && body->texture) 
+            if (!debug && texture) 
             {
-                Graphics::DrawTexture(body->position.x, body->position.y, boxShape->width, boxShape->height, body->rotation, body->texture);
+                Graphics::DrawTexture(position.x, position.y, boxShape->width, boxShape->height, rotation, texture);
             }
             else if (debug) 
             {
-                Graphics::DrawPolygon(body->position.x, body->position.y, boxShape->worldVertices, 0xFF0000FF);
+                // The world doesn't keep the world vertices up to date, only the ones that are drawn are needed
+                boxShape->UpdateVertices(transform);
+                Graphics::DrawPolygon(position.x, position.y, boxShape->worldVertices, boxShape->numVertices, color);
             }
         }
         if (body->shape->GetType() == POLYGON) 
         {
             PolygonShape* polygonShape = (PolygonShape*)body->shape;
-            if (!debug && body->texture) 
+            if (!debug && texture) 
             {
-                Graphics::DrawTexture(body->position.x, body->position.y, polygonShape->width, polygonShape->height, body->rotation, body->texture);
+                Graphics::DrawTexture(position.x, position.y, polygonShape->width, polygonShape->height, rotation, texture);
             }
             else if (debug) 
             {
-                Graphics::DrawPolygon(body->position.x, body->position.y, polygonShape->worldVertices, 0xFF0000FF);
+                // The world doesn't keep the world vertices up to date, only the ones that are drawn are needed
+                polygonShape->UpdateVertices(transform);
+                Graphics::DrawPolygon(position.x, position.y, polygonShape->worldVertices, polygonShape->numVertices, color);
             }
         }
     }
 
+    if (debug)
+    {
+        hud.Render(10, 10, 1000.0f / (framesPerSecond > 0 ? framesPerSecond : stepsPerSecond));
+    }
+
     Graphics::RenderFrame();
 }
 
@@ -192,5 +353,12 @@ void Application::Render()
 void Application::Destroy() {
     delete world;
 
+    for (auto& texture : textures)
+    {
+        SDL_DestroyTexture(texture.second);
+    }
+    textures.clear();
+    bodyTextures.clear();
+
     Graphics::CloseWindow();
 }
\ No newline at end of file
@@ -2,7 +2,11 @@
 #define APPLICATION_H
 
 #include "./Graphics.h"
+#include "./Hud.h"
+#include "./Physics/Constants.h"
 #include "./Physics/World.h"
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 class Application {
@@ -15,11 +19,58 @@ class Application {
 
         World* world;
 
+        // The physics runs fixed steps, as many as the time of the frames
+        // holds. "accumulator" is the time that wasn't stepped yet
+        int stepsPerSecond = PHYSICS_STEPS_PER_SECOND;
+        int framesPerSecond = FPS; // 0 doesn't limit the frames (only vsync does)
+        float accumulator = 0.0f;
+        Uint64 counterPreviousFrame = 0;
+
+        // The bodies are drawn between the state before the last step and the
+        // state after it, at the fraction of a step left in the accumulator.
+        // The handle tells whether the body at an index is still the same one
+        struct BodyState
+        {
+            BodyHandle handle;
+            Vec2 position;
+            float rotation;
+        };
+        std::vector<BodyState> previousStates;
+        float interpolation = 1.0f;
+
+        void SavePreviousStates();
+        void GetRenderState(int index, const Body* body, Vec2& position, float& rotation) const;
+
+        // Performance overlay of the debug mode
+        Hud hud;
+        long long allocationsPreviousFrame = 0;
+
         SDL_Texture* bgTexture;
 
+        // Render data lives here and not in the bodies, so the physics doesn't
+        // depend on SDL. Every file is loaded once and shared by its bodies
+        std::unordered_map<std::string, SDL_Texture*> textures;
+
+        // Texture of every body, indexed by the slot of its handle. A body
+        // created in the slot of a removed one has another generation, so it
+        // doesn't get the old texture
+        struct BodyTexture
+        {
+            int generation;
+            SDL_Texture* texture;
+        };
+        std::vector<BodyTexture> bodyTextures;
+
+        SDL_Texture* LoadTexture(const std::string& textureFileName);
+        // The body must be in the world already, its handle is the key
+        void SetTexture(const Body* body, const char* textureFileName);
+        SDL_Texture* GetTexture(const Body* body) const;
+
     public:
         Application() = default;
         ~Application() = default;
+        void SetPhysicsRate(int stepsPerSecond);
+        void SetRenderRate(int framesPerSecond);
         bool IsRunning();
         void Setup();
         void Input();
@@ -111,25 +111,25 @@ void Graphics::DrawFillRect(int x, int y, int width, int height, Uint32 color) {
     boxColor(renderer, x - width / 2.0, y - height / 2.0, x + width / 2.0, y + height / 2.0, color);
 }
 
-void Graphics::DrawPolygon(int x, int y, const std::vector<Vec2>& vertices, Uint32 color) {
-    for (int i = 0; i < vertices.size(); i++) {
+void Graphics::DrawPolygon(int x, int y, const Vec2* vertices, int numVertices, Uint32 color) {
+    for (int i = 0; i < numVertices; i++) {
         int currIndex = i;
-        int nextIndex = (i + 1) % vertices.size();
+        int nextIndex = (i + 1) % numVertices;
         lineColor(renderer, vertices[currIndex].x, vertices[currIndex].y, vertices[nextIndex].x, vertices[nextIndex].y, color);
     }
     filledCircleColor(renderer, x, y, 1, color);
 }
 
-void Graphics::DrawFillPolygon(int x, int y, const std::vector<Vec2>& vertices, Uint32 color) {
+void Graphics::DrawFillPolygon(int x, int y, const Vec2* vertices, int numVertices, Uint32 color) {
     std::vector<short> vx;
     std::vector<short> vy;
-    for (int i = 0; i < vertices.size(); i++) {
+    for (int i = 0; i < numVertices; i++) {
         vx.push_back(static_cast<int>(vertices[i].x));
     }
-    for (int i = 0; i < vertices.size(); i++) {
+    for (int i = 0; i < numVertices; i++) {
         vy.push_back(static_cast<int>(vertices[i].y));
     }
-    filledPolygonColor(renderer, &vx[0], &vy[0], vertices.size(), color);
+    filledPolygonColor(renderer, &vx[0], &vy[0], numVertices, color);
     filledCircleColor(renderer, x, y, 1, 0xFF000000);
 }
 
@@ -139,6 +139,10 @@ void Graphics::DrawTexture(int x, int y, int width, int height, float rotation,
     SDL_RenderCopyEx(renderer, texture, NULL, &dstRect, rotationDeg, NULL, SDL_FLIP_NONE);
 }
 
+void Graphics::DrawText(int x, int y, const char* text, Uint32 color) {
+    stringColor(renderer, x, y, text, color);
+}
+
 void Graphics::CloseWindow(void) {
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -24,9 +24,11 @@ struct Graphics {
     static void DrawFillCircle(int x, int y, int radius, Uint32 color);
     static void DrawRect(int x, int y, int width, int height, Uint32 color);
     static void DrawFillRect(int x, int y, int width, int height, Uint32 color);
-    static void DrawPolygon(int x, int y, const std::vector<Vec2>& vertices, Uint32 color);
-    static void DrawFillPolygon(int x, int y, const std::vector<Vec2>& vertices, Uint32 color);
+    static void DrawPolygon(int x, int y, const Vec2* vertices, int numVertices, Uint32 color);
+    static void DrawFillPolygon(int x, int y, const Vec2* vertices, int numVertices, Uint32 color);
     static void DrawTexture(int x, int y, int width, int height, float rotation, SDL_Texture* texture);
+    // 8x8 pixel characters, "x" and "y" are the top left corner of the text
+    static void DrawText(int x, int y, const char* text, Uint32 color);
 };
 
 #endif
\ No newline at end of file
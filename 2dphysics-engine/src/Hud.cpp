@@ -0,0 +1,157 @@
+#include "Hud.h"
+
+#include "./Graphics.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// Colors of the phases in the list and in the graph (0xAABBGGRR)
+static const Uint32 phaseColors[NUM_STEP_PHASES] = {
+    0xFF0080FF, // broadphase
+    0xFF00FFFF, // narrowphase
+    0xFFFF00FF, // contacts
+    0xFFA0A0A0, // islands
+    0xFFFFFF00, // integrate forces
+    0xFF80FF80, // presolve
+    0xFF00C000, // solve
+    0xFF006000, // postsolve
+    0xFFFF8000  // integrate velocities
+};
+
+static const Uint32 textColor = 0xFFFFFFFF;
+static const int lineHeight = 12;
+
+const Hud::Frame& Hud::GetFrame(int age) const
+{
+    return history[(numFrames - 1 - age) % HISTORY_SIZE];
+}
+
+void Hud::AddStep(World* world)
+{
+    const StepStats& stats = world->GetStepStats();
+
+    current.stepMs += stats.totalMs;
+    for (int phase = 0; phase < NUM_STEP_PHASES; phase++)
+    {
+        current.phaseMs[phase] += stats.phaseMs[phase];
+    }
+    current.steps++;
+
+    pairs = stats.pairs;
+    contacts = stats.contacts;
+    constraints = stats.constraints;
+}
+
+void Hud::AddFrame(World* world, float frameMs, long long allocations)
+{
+    Frame& frame = history[numFrames % HISTORY_SIZE];
+    frame = current;
+    frame.frameMs = frameMs;
+    frame.allocations = allocations;
+    numFrames++;
+    current = {};
+
+    bodies = world->GetBodies().size();
+    awakeBodies = world->GetIslandStats().awakeBodies;
+    joints = world->GetConstraints().size();
+}
+
+void Hud::Render(int x, int y, float budgetMs) const
+{
+    if (numFrames == 0)
+    {
+        return;
+    }
+
+    // Rolling averages over the last frames
+    const int averageFrames = std::min(numFrames, AVERAGE_FRAMES);
+    float frameMs = 0.0f;
+    float stepMs = 0.0f;
+    float maxStepMs = 0.0f;
+    float steps = 0.0f;
+    float allocations = 0.0f;
+    float phaseMs[NUM_STEP_PHASES] = {};
+    for (int age = 0; age < averageFrames; age++)
+    {
+        const Frame& frame = GetFrame(age);
+        frameMs += frame.frameMs;
+        stepMs += frame.stepMs;
+        maxStepMs = std::max(maxStepMs, frame.stepMs);
+        steps += frame.steps;
+        allocations += frame.allocations;
+        for (int phase = 0; phase < NUM_STEP_PHASES; phase++)
+        {
+            phaseMs[phase] += frame.phaseMs[phase];
+        }
+    }
+
+    const int numLines = 7 + NUM_STEP_PHASES;
+    const int width = HISTORY_SIZE + 160;
+    const int height = numLines * lineHeight + GRAPH_HEIGHT + 24;
+    Graphics::DrawFillRect(x + width / 2, y + height / 2, width, height, 0xC0000000);
+
+    char text[128];
+    int line = y + 8;
+    snprintf(text, sizeof(text), "FPS %5.1f   frame %6.2f ms", frameMs > 0.0f ? 1000.0f * averageFrames / frameMs : 0.0f, frameMs / averageFrames);
+    Graphics::DrawText(x + 8, line, text, textColor);
+    line += lineHeight;
+    snprintf(text, sizeof(text), "physics %6.2f ms  max %6.2f ms  steps %.2f", stepMs / averageFrames, maxStepMs, steps / averageFrames);
+    Graphics::DrawText(x + 8, line, text, textColor);
+    line += lineHeight;
+    snprintf(text, sizeof(text), "bodies %d (%d awake)   joints %d", bodies, awakeBodies, joints);
+    Graphics::DrawText(x + 8, line, text, textColor);
+    line += lineHeight;
+    snprintf(text, sizeof(text), "pairs %d   contacts %d", pairs, contacts);
+    Graphics::DrawText(x + 8, line, text, textColor);
+    line += lineHeight;
+    snprintf(text, sizeof(text), "constraints %d   allocations/frame %.1f", constraints, allocations / averageFrames);
+    Graphics::DrawText(x + 8, line, text, textColor);
+    line += lineHeight * 2;
+
+#if IMPACT_PROFILING
+    snprintf(text, sizeof(text), "phases (ms, last %d frames)", averageFrames);
+#else
+    snprintf(text, sizeof(text), "phases (timers compiled out)");
+#endif
+    Graphics::DrawText(x + 8, line, text, textColor);
+    line += lineHeight;
+    for (int phase = 0; phase < NUM_STEP_PHASES; phase++)
+    {
+        Graphics::DrawFillRect(x + 12, line + 3, 8, 8, phaseColors[phase]);
+        snprintf(text, sizeof(text), "%-22s %7.3f", StepPhaseName((StepPhase)phase), phaseMs[phase] / averageFrames);
+        Graphics::DrawText(x + 24, line, text, textColor);
+        line += lineHeight;
+    }
+
+    // Graph of the last frames, the oldest on the left. The full height is
+    // two frames at the target frame rate, the line in the middle is one frame
+    const int graphLeft = x + 8;
+    const int graphBottom = line + 8 + GRAPH_HEIGHT;
+    const float pixelsPerMs = GRAPH_HEIGHT / (2.0f * budgetMs);
+    const int historyFrames = std::min(numFrames, HISTORY_SIZE);
+    for (int age = 0; age < historyFrames; age++)
+    {
+        const Frame& frame = GetFrame(age);
+        const int column = graphLeft + HISTORY_SIZE - 1 - age;
+
+        // The phases stacked from the bottom, clipped at the top of the graph
+        float bottom = graphBottom;
+        for (int phase = 0; phase < NUM_STEP_PHASES && bottom > graphBottom - GRAPH_HEIGHT; phase++)
+        {
+            float top = std::max(bottom - frame.phaseMs[phase] * pixelsPerMs, (float)(graphBottom - GRAPH_HEIGHT));
+            if (top < bottom - 0.5f)
+            {
+                Graphics::DrawLine(column, bottom, column, top, phaseColors[phase]);
+            }
+            bottom = top;
+        }
+
+        // The whole frame (with the rendering and the waiting) as a dot
+        float frameTop = std::max(graphBottom - frame.frameMs * pixelsPerMs, (float)(graphBottom - GRAPH_HEIGHT));
+        Graphics::DrawLine(column, frameTop, column, frameTop, textColor);
+    }
+    Graphics::DrawLine(graphLeft, graphBottom - GRAPH_HEIGHT / 2, graphLeft + HISTORY_SIZE, graphBottom - GRAPH_HEIGHT / 2, 0x80FFFFFF);
+    Graphics::DrawLine(graphLeft, graphBottom, graphLeft + HISTORY_SIZE, graphBottom, 0x80FFFFFF);
+    snprintf(text, sizeof(text), "%.1f ms", budgetMs);
+    Graphics::DrawText(graphLeft + HISTORY_SIZE + 6, graphBottom - GRAPH_HEIGHT / 2 - 4, text, textColor);
+}
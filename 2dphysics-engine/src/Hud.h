@@ -0,0 +1,57 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include "./Physics/World.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Hud
+///////////////////////////////////////////////////////////////////////////////
+// Performance overlay of the debug mode: FPS, the time of every phase of the
+// steps (World::GetStepStats()) averaged over the last frames, the counts of
+// the world, the heap allocations per frame, and a graph of the last frames
+// with the time of the phases stacked on each other. A frame runs any number
+// of fixed steps, their times are added up.
+///////////////////////////////////////////////////////////////////////////////
+class Hud {
+    private:
+        static const int HISTORY_SIZE = 240;  // frames in the graph, one pixel each
+        static const int AVERAGE_FRAMES = 60; // frames of the rolling averages
+        static const int GRAPH_HEIGHT = 100;
+
+        struct Frame
+        {
+            float frameMs;
+            float stepMs;
+            float phaseMs[NUM_STEP_PHASES];
+            int steps;
+            int allocations;
+        };
+
+        // Ring buffer of the last frames
+        Frame history[HISTORY_SIZE];
+        int numFrames = 0;
+
+        // Steps of the frame that isn't finished yet
+        Frame current = {};
+
+        // Counts of the last frame
+        int bodies = 0;
+        int awakeBodies = 0;
+        int joints = 0;
+        int pairs = 0;
+        int contacts = 0;
+        int constraints = 0;
+
+        // "age" 0 is the last frame
+        const Frame& GetFrame(int age) const;
+
+    public:
+        // Called after every step of the world
+        void AddStep(World* world);
+        // Called once per frame, after its steps
+        void AddFrame(World* world, float frameMs, long long allocations);
+        // "budgetMs" is the time of a frame at the target frame rate
+        void Render(int x, int y, float budgetMs) const;
+};
+
+#endif
@@ -1,8 +1,17 @@
 #include "Application.h"
 
+#include <cstdlib>
+
 int main(int argc, char *args[]) {
     Application app;
 
+    // "app [steps per second] [frames per second]": the rate of the physics
+    // and the frame rate, 0 frames per second only waits for vsync
+    if (argc > 1 && atoi(args[1]) > 0)
+        app.SetPhysicsRate(atoi(args[1]));
+    if (argc > 2 && atoi(args[2]) >= 0)
+        app.SetRenderRate(atoi(args[2]));
+
     app.Setup();
 
     while (app.IsRunning()) {
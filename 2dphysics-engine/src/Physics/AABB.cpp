@@ -0,0 +1,66 @@
+#include "AABB.h"
+
+#include <algorithm>
+
+AABB::AABB() : min(0.0f, 0.0f), max(0.0f, 0.0f)
+{
+}
+
+AABB::AABB(const Vec2& min, const Vec2& max) : min(min), max(max)
+{
+}
+
+bool AABB::Overlaps(const AABB& other) const
+{
+	return min.x <= other.max.x && max.x >= other.min.x &&
+		   min.y <= other.max.y && max.y >= other.min.y;
+}
+
+bool AABB::Contains(const AABB& other) const
+{
+	return min.x <= other.min.x && min.y <= other.min.y &&
+		   max.x >= other.max.x && max.y >= other.max.y;
+}
+
+float AABB::Perimeter() const
+{
+	return 2.0f * ((max.x - min.x) + (max.y - min.y));
+}
+
+AABB AABB::Fatten(float margin) const
+{
+	return AABB(Vec2(min.x - margin, min.y - margin), Vec2(max.x + margin, max.y + margin));
+}
+
+AABB AABB::Extend(const Vec2& displacement) const
+{
+	// Grow the box only on the side the displacement is pointing to
+	AABB result = *this;
+	if (displacement.x < 0.0f)
+	{
+		result.min.x += displacement.x;
+	}
+	else
+	{
+		result.max.x += displacement.x;
+	}
+
+	if (displacement.y < 0.0f)
+	{
+		result.min.y += displacement.y;
+	}
+	else
+	{
+		result.max.y += displacement.y;
+	}
+
+	return result;
+}
+
+AABB AABB::Union(const AABB& a, const AABB& b)
+{
+	return AABB(
+		Vec2(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)),
+		Vec2(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y))
+	);
+}
@@ -0,0 +1,24 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include "./Vec2.h"
+
+// Axis-aligned bounding box used by the broadphase
+struct AABB
+{
+	Vec2 min;
+	Vec2 max;
+
+	AABB();
+	AABB(const Vec2& min, const Vec2& max);
+
+	bool Overlaps(const AABB& other) const;     // a.Overlaps(b)
+	bool Contains(const AABB& other) const;     // a.Contains(b)
+	float Perimeter() const;                    // a.Perimeter()
+	AABB Fatten(float margin) const;            // a.Fatten(margin)
+	AABB Extend(const Vec2& displacement) const; // a.Extend(d)
+
+	static AABB Union(const AABB& a, const AABB& b);
+};
+
+#endif
@@ -1,44 +1,68 @@
 #include "Body.h"
-#include "../Graphics.h"
+#include "Constants.h"
 
 #include <iostream>
 #include <cmath>
 
+// Never destroyed, objects may still be deleted by static destructors at exit
+static Pool& BodyPool()
+{
+	static Pool* pool = new Pool(sizeof(Body));
+	return *pool;
+}
+
+void* Body::operator new(std::size_t size)
+{
+	return AllocateFromPool(BodyPool(), size);
+}
+
+void Body::operator delete(void* block, std::size_t size)
+{
+	FreeToPool(BodyPool(), block, size);
+}
+
+const PoolStats& Body::GetPoolStats()
+{
+	return BodyPool().GetStats();
+}
+
 Body::Body(const Shape& shape, float x, float y, float mass)
 {
 	this->shape = shape.Clone();
-	this->position = Vec2(x, y);
-	this->velocity = Vec2(0, 0);
-	this->acceleration = Vec2(0, 0);
-	this->rotation = 0.0;
-	this->angularVelocity = 0.0;
-	this->angularAcceleration = 0.0;
-	this->sumForces = Vec2(0, 0);
-	this->sumTorque = 0.0;
+	this->state.position = Vec2(x, y);
+	this->state.velocity = Vec2(0, 0);
+	this->state.rotation = 0.0;
+	this->state.angularVelocity = 0.0;
+	this->state.sumForces = Vec2(0, 0);
+	this->state.sumTorque = 0.0;
+	this->state.isAwake = true;
 	this->restitution = 0.6;
 	this->friction = 0.7;
+	this->sleepTime = 0.0;
+	this->linearSleepTolerance = LINEAR_SLEEP_TOLERANCE;
+	this->angularSleepTolerance = ANGULAR_SLEEP_TOLERANCE;
 
 	this->mass = mass;
 	if (mass != 0.0)
 	{
-		this->invMass = 1.0 / mass;
+		this->state.invMass = 1.0 / mass;
 	}
 	else
 	{
-		this->invMass = 0.0;
+		this->state.invMass = 0.0;
 	}
 
 	I = shape.GetMomentOfInertia() * mass;
 	if (I != 0.0)
 	{
-		this->invI = 1.0 / I;
+		this->state.invI = 1.0 / I;
 	}
 	else
 	{
-		this->invI = 0.0;
+		this->state.invI = 0.0;
 	}
 
-	this->shape->UpdateVertices(rotation, position);
+	this->shape->UpdateVertices(GetTransform());
 
 	std::cout << "Body constructor called!" << std::endl;
 }
@@ -48,142 +72,173 @@ Body::~Body()
 	// Deallocate shape
 	delete shape;
 
-	// Deallocate texture
-	SDL_DestroyTexture(texture);
+	// Free the slot of the store
+	if (store)
+	{
+		store->Destroy(handle);
+	}
 
 	std::cout << "Body destructor called!" << std::endl;
 }
 
-void Body::SetTexture(const char* textureFileName)
+void Body::AttachToStore(BodyStore* store)
 {
-	// Load the file from "textureFileName" as an SDL_Texture
-	SDL_Surface* surface = IMG_Load(textureFileName);
-	if (surface)
-	{
-		texture = SDL_CreateTextureFromSurface(Graphics::renderer, surface);
-		SDL_FreeSurface(surface);
-	}
-	else
-	{
-		std::cerr << "Error loading texture: " << textureFileName << std::endl;
-	}
+	this->handle = store->Create(this, state);
+	this->store = store;
+}
+
+BodyHandle Body::GetHandle() const
+{
+	return handle;
 }
 
 Vec2 Body::LocalSpaceToWorldSpace(const Vec2& point) const
 {
-	Vec2 rotated = point.Rotate(rotation);
-	return rotated + position;
+	return GetTransform().Apply(point);
 }
 
 Vec2 Body::WorldSpaceToLocalSpace(const Vec2& point) const
 {
-	float translatedX = point.x - position.x;
-	float translatedY = point.y - position.y;
-	float rotatedX = cos(-rotation) * translatedX - sin(-rotation) * translatedY;
-	float rotatedY = cos(-rotation) * translatedY + sin(-rotation) * translatedX;
-
-	return Vec2(rotatedX, rotatedY);
+	return GetTransform().ApplyInverse(point);
 }
 
 bool Body::IsStatic() const
 {
 	const float epsilon = 0.005f;
-	return fabs(invMass - 0.0) < epsilon;
+	return fabs(GetInvMass() - 0.0) < epsilon;
 }
 
-void Body::AddForce(const Vec2& force)
+bool Body::IsAwake() const
 {
-	sumForces += force;
+	return store ? (store->flags[handle.index] & BodyStore::BODY_AWAKE) != 0 : state.isAwake;
 }
 
-void Body::AddTorque(float torque)
+void Body::SetAwake(bool awake)
 {
-	sumTorque += torque;
-}
+	if (store)
+	{
+		store->SetAwake(handle.index, awake);
+	}
+	else
+	{
+		state.isAwake = awake;
+	}
+	sleepTime = 0.0;
 
+	if (!awake)
+	{
+		// A sleeping body must not keep moving or accumulating forces
+		VelocityRef() = Vec2(0.0, 0.0);
+		AngularVelocityRef() = 0.0;
+		ClearForces();
+		ClearTorque();
+	}
+}
 
-void Body::ClearForces()
+void Body::UpdateSleepTime(const float dt)
 {
-	sumForces = Vec2(0.0, 0.0);
+	if (IsStatic() || !IsAwake())
+	{
+		return;
+	}
+
+	if (GetVelocity().MagnitudeSquared() > linearSleepTolerance * linearSleepTolerance ||
+		fabs(GetAngularVelocity()) > angularSleepTolerance)
+	{
+		sleepTime = 0.0;
+	}
+	else
+	{
+		sleepTime += dt;
+	}
 }
 
-void Body::ClearTorque()
+void Body::WakeUp()
 {
-	sumTorque = 0.0;
+	if (!IsStatic() && !IsAwake())
+	{
+		SetAwake(true);
+	}
 }
 
-void Body::ApplyImpulseLinear(const Vec2& j)
+void Body::AddForce(const Vec2& force)
 {
-	if (IsStatic())
+	WakeUp();
+	if (store)
 	{
-		return;
+		store->forces[handle.index] += force;
 	}
+	else
+	{
+		state.sumForces += force;
+	}
+}
 
-	velocity += j * invMass;
+void Body::AddTorque(float torque)
+{
+	WakeUp();
+	if (store)
+	{
+		store->torques[handle.index] += torque;
+	}
+	else
+	{
+		state.sumTorque += torque;
+	}
 }
 
-void Body::ApplyImpulseAngular(const float j)
+
+void Body::ClearForces()
 {
-	if (IsStatic())
+	if (store)
 	{
-		return;
+		store->forces[handle.index] = Vec2(0.0, 0.0);
 	}
+	else
+	{
+		state.sumForces = Vec2(0.0, 0.0);
+	}
+}
 
-	angularVelocity += j * invI;
+void Body::ClearTorque()
+{
+	if (store)
+	{
+		store->torques[handle.index] = 0.0;
+	}
+	else
+	{
+		state.sumTorque = 0.0;
+	}
 }
 
-void Body::ApplyImpulseAtPoint(const Vec2& j, const Vec2& r)
+void Body::ApplyImpulseLinear(const Vec2& j)
 {
 	if (IsStatic())
 	{
 		return;
 	}
 
-	velocity += j * invMass;
-	angularVelocity += r.Cross(j) * invI;
+	VelocityRef() += j * GetInvMass();
 }
 
-void Body::IntegrateForces(const float dt)
+void Body::ApplyImpulseAngular(const float j)
 {
 	if (IsStatic())
 	{
 		return;
 	}
 
-	// Find the linear acceleration based on the forces that are being applied and the mass
-	acceleration = sumForces * invMass;
-
-	// Implicit Euler Integration
-	// Integrate the linear acceleration to find the new linear velocity
-	velocity += acceleration * dt;
-
-	// Find the angular acceleration based on the torque that is being applied and the moment of inertia
-	angularAcceleration = sumTorque * invI;
-
-	// Implicit Euler Integration
-	// Integrate the angular acceleration to find the new angular velocity
-	angularVelocity += angularAcceleration * dt;
-
-
-	// Clear all the forces and torque acting on the object before the next physics step
-	ClearForces();
-	ClearTorque();
+	AngularVelocityRef() += j * GetInvI();
 }
 
-void Body::IntegrateVelocities(const float dt)
+void Body::ApplyImpulseAtPoint(const Vec2& j, const Vec2& r)
 {
 	if (IsStatic())
 	{
-		//shape->UpdateVertices(rotation, position);
 		return;
 	}
 
-	// Integrate the velocity to find the new position
-	position += velocity * dt;
-
-	// Integrate the angular velocity to find the new angular rotation angle
-	rotation += angularVelocity * dt;
-
-	// Update the vertices to adjust them to the new position/rotation
-	shape->UpdateVertices(rotation, position);
-}
\ No newline at end of file
+	VelocityRef() += j * GetInvMass();
+	AngularVelocityRef() += r.Cross(j) * GetInvI();
+}
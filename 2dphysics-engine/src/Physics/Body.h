@@ -1,33 +1,34 @@
 #ifndef BODY_H
 #define BODY_H
 
-#include <SDL.h>
-#include <SDL_image.h>
-
 #include "./Vec2.h"
 #include "./Shape.h"
+#include "./BodyStore.h"
+#include "./Pool.h"
 
 struct Body
 {
-	// Linear motion
-	Vec2 position;
-	Vec2 velocity;
-	Vec2 acceleration;
-
-	//Angular motion
-	float rotation;
-	float angularVelocity;
-	float angularAcceleration;
-
-	// Forces and torque
-	Vec2 sumForces;
-	float sumTorque;
-
+private:
+	// Motion state while the body isn't in a world, afterwards it lives in the
+	// world's BodyStore (structure of arrays) and the body only keeps its handle
+	BodyState state;
+	BodyStore* store = nullptr;
+	BodyHandle handle;
+
+	// Called by the setters and AddForce()/AddTorque(): a dynamic body that is
+	// moved or pushed by hand doesn't stay asleep
+	void WakeUp();
+
+	// Writable motion state, only for the setters and the impulses: writing it
+	// from outside would skip the moved flag and the wake up
+	Vec2& PositionRef();
+	Vec2& VelocityRef();
+	float& AngularVelocityRef();
+
+public:
 	// Mass and Moment of Inertia
 	float mass;
-	float invMass;
 	float I;
-	float invI;
 
 	// Coefficient of restitution (elasticity)
 	float restitution;
@@ -35,34 +36,174 @@ struct Body
 	// Coefficient of friction
 	float friction;
 
+	// Sleeping: a body that stays slower than the tolerances for long enough
+	// stops being simulated until something wakes it (see IslandGraph)
+	float sleepTime;
+	float linearSleepTolerance;
+	float angularSleepTolerance;
+
+	// Position in the world's list of bodies (-1 until it is added to a world)
+	int index = -1;
 
 	// Pointer to the shape/geometry of this rigid body
 	Shape* shape = nullptr;
 
-	// Pointer to an SDL texture
-	SDL_Texture* texture = nullptr;
-
 	Body(const Shape& shape, float x, float y, float mass);
 	~Body();
 
+	// Allocated from a pool (see Pool.h)
+	static void* operator new(std::size_t size);
+	static void operator delete(void* block, std::size_t size);
+	static const PoolStats& GetPoolStats();
+
+	// Moves the motion state into a store (called by World::AddBody)
+	void AttachToStore(BodyStore* store);
+	BodyHandle GetHandle() const;
+
+	// Linear motion
+	const Vec2& GetPosition() const;
+	void SetPosition(const Vec2& position);
+	const Vec2& GetVelocity() const;
+	void SetVelocity(const Vec2& velocity);
+
+	// Angular motion. The rotation is only changed with SetRotation(), so the
+	// cached cos/sin (used by GetTransform() and the collision tests) follow
+	float GetRotation() const;
+	void SetRotation(float rotation);
+	float GetAngularVelocity() const;
+	void SetAngularVelocity(float angularVelocity);
+
+	// Forces and torque accumulated until the next step
+	const Vec2& GetSumForces() const;
+	float GetSumTorque() const;
+
+	float GetInvMass() const;
+	float GetInvI() const;
+
+	// Position and cos/sin of the rotation (computed once per step in a world)
+	Transform GetTransform() const;
+
 	bool IsStatic() const;
 
+	bool IsAwake() const;
+	void SetAwake(bool awake);
+	void UpdateSleepTime(const float dt);
+
 	void AddForce(const Vec2& force);
 	void AddTorque(float torque);
 	void ClearForces();
 	void ClearTorque();
 
-	void SetTexture(const char* textureFileName);
-
 	Vec2 LocalSpaceToWorldSpace(const Vec2& point) const;
 	Vec2 WorldSpaceToLocalSpace(const Vec2& point) const;
 
 	void ApplyImpulseLinear(const Vec2& j);
 	void ApplyImpulseAngular(const float j);
 	void ApplyImpulseAtPoint(const Vec2& j, const Vec2& r);
-
-	void IntegrateForces(const float dt);
-	void IntegrateVelocities(const float dt);
 };
 
-#endif
\ No newline at end of file
+// The accessors are used by every constraint and collision test, so they are
+// inline. Once the body is in a world its handle index is its slot in the store.
+
+inline Vec2& Body::PositionRef()
+{
+	return store ? store->positions[handle.index] : state.position;
+}
+
+inline const Vec2& Body::GetPosition() const
+{
+	return store ? store->positions[handle.index] : state.position;
+}
+
+inline void Body::SetPosition(const Vec2& position)
+{
+	PositionRef() = position;
+	if (store)
+	{
+		store->MarkMoved(handle.index);
+	}
+	WakeUp();
+}
+
+inline Vec2& Body::VelocityRef()
+{
+	return store ? store->velocities[handle.index] : state.velocity;
+}
+
+inline const Vec2& Body::GetVelocity() const
+{
+	return store ? store->velocities[handle.index] : state.velocity;
+}
+
+inline void Body::SetVelocity(const Vec2& velocity)
+{
+	VelocityRef() = velocity;
+	WakeUp();
+}
+
+inline float Body::GetRotation() const
+{
+	return store ? store->rotations[handle.index] : state.rotation;
+}
+
+inline void Body::SetRotation(float rotation)
+{
+	if (store)
+	{
+		store->rotations[handle.index] = rotation;
+		store->cachedRotations[handle.index] = Rotation(rotation);
+		store->MarkMoved(handle.index);
+	}
+	else
+	{
+		state.rotation = rotation;
+	}
+	WakeUp();
+}
+
+inline float& Body::AngularVelocityRef()
+{
+	return store ? store->angularVelocities[handle.index] : state.angularVelocity;
+}
+
+inline float Body::GetAngularVelocity() const
+{
+	return store ? store->angularVelocities[handle.index] : state.angularVelocity;
+}
+
+inline void Body::SetAngularVelocity(float angularVelocity)
+{
+	AngularVelocityRef() = angularVelocity;
+	WakeUp();
+}
+
+inline const Vec2& Body::GetSumForces() const
+{
+	return store ? store->forces[handle.index] : state.sumForces;
+}
+
+inline float Body::GetSumTorque() const
+{
+	return store ? store->torques[handle.index] : state.sumTorque;
+}
+
+inline float Body::GetInvMass() const
+{
+	return store ? store->invMasses[handle.index] : state.invMass;
+}
+
+inline float Body::GetInvI() const
+{
+	return store ? store->invIs[handle.index] : state.invI;
+}
+
+inline Transform Body::GetTransform() const
+{
+	if (store)
+	{
+		return Transform(store->positions[handle.index], store->cachedRotations[handle.index]);
+	}
+	return Transform(state.position, Rotation(state.rotation));
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include "BodyStore.h"
+#include "IntegrationKernels.h"
+#include "Simd.h"
+
+#include <cmath>
+
+BodyHandle BodyStore::Create(Body* owner, const BodyState& state)
+{
+	int slot;
+	if (!freeSlots.empty())
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		slot = positions.size();
+		positions.push_back(Vec2());
+		velocities.push_back(Vec2());
+		forces.push_back(Vec2());
+		rotations.push_back(0.0);
+		cachedRotations.push_back(Rotation());
+		angularVelocities.push_back(0.0);
+		torques.push_back(0.0);
+		invMasses.push_back(0.0);
+		invIs.push_back(0.0);
+		flags.push_back(0);
+		owners.push_back(nullptr);
+		generations.push_back(0);
+	}
+
+	positions[slot] = state.position;
+	velocities[slot] = state.velocity;
+	forces[slot] = state.sumForces;
+	rotations[slot] = state.rotation;
+	cachedRotations[slot] = Rotation(state.rotation);
+	angularVelocities[slot] = state.angularVelocity;
+	torques[slot] = state.sumTorque;
+	invMasses[slot] = state.invMass;
+	invIs[slot] = state.invI;
+	owners[slot] = owner;
+
+	// Same threshold as Body::IsStatic()
+	flags[slot] = BODY_ALIVE;
+	if (fabs(state.invMass) < 0.005f)
+	{
+		flags[slot] |= BODY_STATIC;
+	}
+	if (state.isAwake)
+	{
+		flags[slot] |= BODY_AWAKE;
+	}
+
+	BodyHandle handle;
+	handle.index = slot;
+	handle.generation = generations[slot];
+	return handle;
+}
+
+void BodyStore::Destroy(BodyHandle handle)
+{
+	if (!IsValid(handle))
+	{
+		return;
+	}
+
+	flags[handle.index] = 0;
+	owners[handle.index] = nullptr;
+	generations[handle.index]++;
+	freeSlots.push_back(handle.index);
+}
+
+bool BodyStore::IsValid(BodyHandle handle) const
+{
+	return handle.index >= 0 && handle.index < (int)generations.size() && generations[handle.index] == handle.generation && (flags[handle.index] & BODY_ALIVE);
+}
+
+int BodyStore::GetNumSlots() const
+{
+	return positions.size();
+}
+
+bool BodyStore::IsSimulated(int slot) const
+{
+	return (flags[slot] & (BODY_ALIVE | BODY_AWAKE | BODY_STATIC)) == (BODY_ALIVE | BODY_AWAKE);
+}
+
+void BodyStore::SetAwake(int slot, bool awake)
+{
+	if (awake)
+	{
+		flags[slot] |= BODY_AWAKE;
+	}
+	else
+	{
+		flags[slot] &= ~BODY_AWAKE;
+	}
+}
+
+void BodyStore::MarkMoved(int slot)
+{
+	if (!(flags[slot] & BODY_MOVED))
+	{
+		flags[slot] |= BODY_MOVED;
+		movedSlots.push_back(slot);
+	}
+}
+
+void BodyStore::IntegrateForces(int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt)
+{
+	switch (GetSimdLevel())
+	{
+		case SIMD_AVX2: IntegrateForcesAVX2(*this, begin, end, gravity, force, torque, dt); break;
+		case SIMD_SSE2: IntegrateForcesSSE2(*this, begin, end, gravity, force, torque, dt); break;
+		default: IntegrateForcesScalar(*this, begin, end, gravity, force, torque, dt); break;
+	}
+}
+
+void BodyStore::IntegrateVelocities(int begin, int end, float dt)
+{
+	switch (GetSimdLevel())
+	{
+		case SIMD_AVX2: IntegrateVelocitiesAVX2(*this, begin, end, dt); break;
+		case SIMD_SSE2: IntegrateVelocitiesSSE2(*this, begin, end, dt); break;
+		default: IntegrateVelocitiesScalar(*this, begin, end, dt); break;
+	}
+}
+
+void BodyStore::UpdateRotations(int begin, int end)
+{
+	for (int i = begin; i < end; i++)
+	{
+		if (IsSimulated(i))
+		{
+			cachedRotations[i] = Rotation(rotations[i]);
+		}
+	}
+}
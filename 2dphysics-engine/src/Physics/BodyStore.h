@@ -0,0 +1,105 @@
+#ifndef BODYSTORE_H
+#define BODYSTORE_H
+
+#include "./Vec2.h"
+#include "./Transform.h"
+
+#include <cstdint>
+#include <vector>
+
+struct Body;
+
+// Refers to a slot of a BodyStore. The generation changes every time the slot
+// is freed, so a handle of a destroyed body never reaches the body that reuses it.
+struct BodyHandle
+{
+	int index = -1;
+	int generation = 0;
+};
+
+// Motion state of a body, kept in the body itself until it is added to a world
+struct BodyState
+{
+	Vec2 position;
+	Vec2 velocity;
+	Vec2 sumForces;
+	float rotation = 0.0;
+	float angularVelocity = 0.0;
+	float sumTorque = 0.0;
+	float invMass = 0.0;
+	float invI = 0.0;
+	bool isAwake = true;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BodyStore
+///////////////////////////////////////////////////////////////////////////////
+// Structure of arrays with the motion state of all the bodies of a world:
+// positions, velocities, rotations, inverse masses... each live in their own
+// contiguous array, so the integration loops only walk through the data they
+// use. Body is a thin facade over one slot of the store.
+//
+// Freed slots are reused (through a free list) but never moved, so a slot
+// index stays valid for the whole life of its body. Free slots are flagged as
+// not simulated and skipped by the integration loops.
+///////////////////////////////////////////////////////////////////////////////
+class BodyStore
+{
+private:
+	std::vector<int> generations;
+	std::vector<int> freeSlots;
+
+public:
+	enum BodyFlags
+	{
+		BODY_ALIVE = 1,
+		BODY_AWAKE = 2,
+		BODY_STATIC = 4,
+		BODY_MOVED = 8 // moved by hand since the last step, see MarkMoved()
+	};
+
+	std::vector<Vec2> positions;
+	std::vector<Vec2> velocities;
+	std::vector<Vec2> forces;
+	std::vector<float> rotations;
+	std::vector<Rotation> cachedRotations; // cos/sin of the rotations, see UpdateRotations()
+	std::vector<float> angularVelocities;
+	std::vector<float> torques;
+	std::vector<float> invMasses;
+	std::vector<float> invIs;
+	std::vector<uint8_t> flags;
+	std::vector<Body*> owners;
+
+	// Slots moved with Body::SetPosition()/SetRotation() since the world last
+	// refreshed their broadphase proxies
+	std::vector<int> movedSlots;
+
+	BodyStore() = default;
+	~BodyStore() = default;
+
+	BodyHandle Create(Body* owner, const BodyState& state);
+	void Destroy(BodyHandle handle);
+	bool IsValid(BodyHandle handle) const;
+
+	// Number of slots, including the free ones
+	int GetNumSlots() const;
+
+	// Not static, awake and alive
+	bool IsSimulated(int slot) const;
+	void SetAwake(int slot, bool awake);
+	void MarkMoved(int slot);
+
+	// Adds the forces and gravity to the velocities of the simulated bodies in
+	// [begin, end) and clears their forces and torques (semi-implicit Euler).
+	// Both run the kernels of GetSimdLevel(), see IntegrationKernels.h
+	void IntegrateForces(int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt);
+
+	// Moves the simulated bodies in [begin, end) with their velocities
+	void IntegrateVelocities(int begin, int end, float dt);
+
+	// Computes the cos/sin of the simulated bodies in [begin, end) after they
+	// moved. Everything else (static and sleeping bodies) didn't rotate
+	void UpdateRotations(int begin, int end);
+};
+
+#endif
@@ -0,0 +1,817 @@
+#include "Broadphase.h"
+#include "Constants.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Pairs are sorted so the narrowphase always sees them in the same order,
+// no matter in which order the broadphase found them
+static bool ComparePairs(const BroadphasePair& p1, const BroadphasePair& p2)
+{
+	if (p1.a != p2.a)
+	{
+		return p1.a < p2.a;
+	}
+	return p1.b < p2.b;
+}
+
+const BroadphaseStats& Broadphase::GetStats() const
+{
+	return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// All pairs
+///////////////////////////////////////////////////////////////////////////////
+BroadphaseType AllPairs::GetType() const
+{
+	return ALL_PAIRS;
+}
+
+void AllPairs::CreateProxy(int proxy, const AABB& aabb, bool isStatic)
+{
+	if (proxy >= (int)proxyState.size())
+	{
+		proxyState.resize(proxy + 1, -1);
+	}
+	proxyState[proxy] = isStatic ? 1 : 0;
+	stats.proxies++;
+}
+
+void AllPairs::DestroyProxy(int proxy)
+{
+	proxyState[proxy] = -1;
+	stats.proxies--;
+}
+
+void AllPairs::MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement)
+{
+	return; // Every pair is reported anyway, nothing to keep track of
+}
+
+void AllPairs::SetProxyStatic(int proxy, bool isStatic)
+{
+	proxyState[proxy] = isStatic ? 1 : 0;
+}
+
+void AllPairs::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+	pairs.clear();
+
+	for (int i = 0; i < (int)proxyState.size(); i++)
+	{
+		if (proxyState[i] == -1)
+		{
+			continue;
+		}
+
+		for (int j = i + 1; j < (int)proxyState.size(); j++)
+		{
+			if (proxyState[j] == -1 || (proxyState[i] == 1 && proxyState[j] == 1))
+			{
+				continue;
+			}
+			pairs.push_back({ i, j });
+		}
+	}
+
+	stats.overlapTests = 0;
+	stats.pairs = pairs.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Dynamic AABB tree
+///////////////////////////////////////////////////////////////////////////////
+const float AABBTree::MARGIN = 0.1f * PIXELS_PER_METER; // 10 cm
+const float AABBTree::DISPLACEMENT_MULTIPLIER = 4.0f;
+
+BroadphaseType AABBTree::GetType() const
+{
+	return AABB_TREE;
+}
+
+bool AABBTree::Node::IsLeaf() const
+{
+	return child1 == -1;
+}
+
+int AABBTree::AllocateNode()
+{
+	int node;
+	if (freeList == -1)
+	{
+		node = nodes.size();
+		nodes.push_back(Node());
+	}
+	else
+	{
+		node = freeList;
+		freeList = nodes[node].parent;
+	}
+
+	nodes[node].parent = -1;
+	nodes[node].child1 = -1;
+	nodes[node].child2 = -1;
+	nodes[node].height = 0;
+	nodes[node].proxy = -1;
+	nodes[node].isStatic = false;
+
+	return node;
+}
+
+void AABBTree::FreeNode(int node)
+{
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+void AABBTree::CreateProxy(int proxy, const AABB& aabb, bool isStatic)
+{
+	if (proxy >= (int)proxyToNode.size())
+	{
+		proxyToNode.resize(proxy + 1, -1);
+	}
+
+	int leaf = AllocateNode();
+	nodes[leaf].aabb = aabb.Fatten(MARGIN);
+	nodes[leaf].proxy = proxy;
+	nodes[leaf].isStatic = isStatic;
+	proxyToNode[proxy] = leaf;
+
+	InsertLeaf(leaf);
+	stats.proxies++;
+}
+
+void AABBTree::DestroyProxy(int proxy)
+{
+	int leaf = proxyToNode[proxy];
+	RemoveLeaf(leaf);
+	FreeNode(leaf);
+	proxyToNode[proxy] = -1;
+	stats.proxies--;
+}
+
+void AABBTree::MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement)
+{
+	int leaf = proxyToNode[proxy];
+
+	// The body is still inside its fat AABB, nothing to do
+	if (nodes[leaf].aabb.Contains(aabb))
+	{
+		return;
+	}
+
+	RemoveLeaf(leaf);
+	nodes[leaf].aabb = aabb.Fatten(MARGIN).Extend(displacement * DISPLACEMENT_MULTIPLIER);
+	InsertLeaf(leaf);
+}
+
+void AABBTree::SetProxyStatic(int proxy, bool isStatic)
+{
+	nodes[proxyToNode[proxy]].isStatic = isStatic;
+}
+
+void AABBTree::InsertLeaf(int leaf)
+{
+	if (root == -1)
+	{
+		root = leaf;
+		nodes[root].parent = -1;
+		return;
+	}
+
+	// Find the best sibling for the new leaf (surface area heuristic)
+	const AABB leafAABB = nodes[leaf].aabb;
+	int index = root;
+	while (!nodes[index].IsLeaf())
+	{
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		float area = nodes[index].aabb.Perimeter();
+		float combinedArea = AABB::Union(nodes[index].aabb, leafAABB).Perimeter();
+
+		// Cost of creating a new parent for this node and the new leaf
+		float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		// Cost of descending into each child
+		float cost1 = AABB::Union(leafAABB, nodes[child1].aabb).Perimeter() + inheritanceCost;
+		if (!nodes[child1].IsLeaf())
+		{
+			cost1 -= nodes[child1].aabb.Perimeter();
+		}
+
+		float cost2 = AABB::Union(leafAABB, nodes[child2].aabb).Perimeter() + inheritanceCost;
+		if (!nodes[child2].IsLeaf())
+		{
+			cost2 -= nodes[child2].aabb.Perimeter();
+		}
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = (cost1 < cost2) ? child1 : child2;
+	}
+
+	int sibling = index;
+
+	// Create a new parent holding the sibling and the new leaf
+	int oldParent = nodes[sibling].parent;
+	int newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].aabb = AABB::Union(leafAABB, nodes[sibling].aabb);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent != -1)
+	{
+		if (nodes[oldParent].child1 == sibling)
+		{
+			nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		root = newParent;
+	}
+
+	// Walk back up the tree fixing heights and AABBs
+	Refit(nodes[leaf].parent);
+}
+
+void AABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = -1;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent != -1)
+	{
+		// Destroy the parent and connect the sibling to the grand parent
+		if (nodes[grandParent].child1 == parent)
+		{
+			nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			nodes[grandParent].child2 = sibling;
+		}
+		nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		Refit(grandParent);
+	}
+	else
+	{
+		root = sibling;
+		nodes[sibling].parent = -1;
+		FreeNode(parent);
+	}
+}
+
+void AABBTree::Refit(int index)
+{
+	while (index != -1)
+	{
+		index = Balance(index);
+
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+		nodes[index].aabb = AABB::Union(nodes[child1].aabb, nodes[child2].aabb);
+
+		index = nodes[index].parent;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Perform a left or right rotation if node A is imbalanced
+///////////////////////////////////////////////////////////////////////////////
+// A has the children B and C, B has the children D and E and C has the
+// children F and G. The taller child of A is rotated up to take its place.
+///////////////////////////////////////////////////////////////////////////////
+// Returns the index of the node that took the place of A
+///////////////////////////////////////////////////////////////////////////////
+int AABBTree::Balance(int iA)
+{
+	Node* A = &nodes[iA];
+	if (A->IsLeaf() || A->height < 2)
+	{
+		return iA;
+	}
+
+	int iB = A->child1;
+	int iC = A->child2;
+	Node* B = &nodes[iB];
+	Node* C = &nodes[iC];
+
+	int balance = C->height - B->height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		int iF = C->child1;
+		int iG = C->child2;
+		Node* F = &nodes[iF];
+		Node* G = &nodes[iG];
+
+		// Swap A and C
+		C->child1 = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		// A's old parent should point to C
+		if (C->parent != -1)
+		{
+			if (nodes[C->parent].child1 == iA)
+			{
+				nodes[C->parent].child1 = iC;
+			}
+			else
+			{
+				nodes[C->parent].child2 = iC;
+			}
+		}
+		else
+		{
+			root = iC;
+		}
+
+		// Rotate
+		if (F->height > G->height)
+		{
+			C->child2 = iF;
+			A->child2 = iG;
+			G->parent = iA;
+			A->aabb = AABB::Union(B->aabb, G->aabb);
+			C->aabb = AABB::Union(A->aabb, F->aabb);
+			A->height = 1 + std::max(B->height, G->height);
+			C->height = 1 + std::max(A->height, F->height);
+		}
+		else
+		{
+			C->child2 = iG;
+			A->child2 = iF;
+			F->parent = iA;
+			A->aabb = AABB::Union(B->aabb, F->aabb);
+			C->aabb = AABB::Union(A->aabb, G->aabb);
+			A->height = 1 + std::max(B->height, F->height);
+			C->height = 1 + std::max(A->height, G->height);
+		}
+
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		int iD = B->child1;
+		int iE = B->child2;
+		Node* D = &nodes[iD];
+		Node* E = &nodes[iE];
+
+		// Swap A and B
+		B->child1 = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		// A's old parent should point to B
+		if (B->parent != -1)
+		{
+			if (nodes[B->parent].child1 == iA)
+			{
+				nodes[B->parent].child1 = iB;
+			}
+			else
+			{
+				nodes[B->parent].child2 = iB;
+			}
+		}
+		else
+		{
+			root = iB;
+		}
+
+		// Rotate
+		if (D->height > E->height)
+		{
+			B->child2 = iD;
+			A->child1 = iE;
+			E->parent = iA;
+			A->aabb = AABB::Union(C->aabb, E->aabb);
+			B->aabb = AABB::Union(A->aabb, D->aabb);
+			A->height = 1 + std::max(C->height, E->height);
+			B->height = 1 + std::max(A->height, D->height);
+		}
+		else
+		{
+			B->child2 = iE;
+			A->child1 = iD;
+			D->parent = iA;
+			A->aabb = AABB::Union(C->aabb, D->aabb);
+			B->aabb = AABB::Union(A->aabb, E->aabb);
+			A->height = 1 + std::max(C->height, D->height);
+			B->height = 1 + std::max(A->height, E->height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void AABBTree::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+	pairs.clear();
+	stats.overlapTests = 0;
+
+	if (root == -1)
+	{
+		stats.pairs = 0;
+		return;
+	}
+
+	// Only moving bodies query the tree, static bodies are found by them
+	for (int proxy = 0; proxy < (int)proxyToNode.size(); proxy++)
+	{
+		int leaf = proxyToNode[proxy];
+		if (leaf == -1 || nodes[leaf].isStatic)
+		{
+			continue;
+		}
+
+		const AABB& fatAABB = nodes[leaf].aabb;
+
+		stack.clear();
+		stack.push_back(root);
+		while (!stack.empty())
+		{
+			int index = stack.back();
+			stack.pop_back();
+
+			const Node& node = nodes[index];
+			stats.overlapTests++;
+			if (!node.aabb.Overlaps(fatAABB))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				int other = node.proxy;
+				if (node.isStatic)
+				{
+					pairs.push_back({ std::min(proxy, other), std::max(proxy, other) });
+				}
+				else if (proxy < other)
+				{
+					// Both moving, so the pair is found twice. Keep only one of them.
+					pairs.push_back({ proxy, other });
+				}
+			}
+			else
+			{
+				stack.push_back(node.child1);
+				stack.push_back(node.child2);
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end(), ComparePairs);
+	stats.pairs = pairs.size();
+}
+
+int AABBTree::GetHeight() const
+{
+	if (root == -1)
+	{
+		return 0;
+	}
+	return nodes[root].height;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Uniform spatial hash
+///////////////////////////////////////////////////////////////////////////////
+const float SpatialHash::DEFAULT_CELL_SIZE = 2.0f * PIXELS_PER_METER;
+
+SpatialHash::SpatialHash(float cellSize)
+{
+	this->cellSize = cellSize;
+}
+
+BroadphaseType SpatialHash::GetType() const
+{
+	return SPATIAL_HASH;
+}
+
+float SpatialHash::GetCellSize() const
+{
+	return cellSize;
+}
+
+void SpatialHash::CreateProxy(int proxy, const AABB& aabb, bool isStatic)
+{
+	if (proxy >= (int)proxies.size())
+	{
+		proxies.resize(proxy + 1, { AABB(), false, false });
+	}
+	proxies[proxy] = { aabb, isStatic, true };
+	stats.proxies++;
+}
+
+void SpatialHash::DestroyProxy(int proxy)
+{
+	proxies[proxy].isActive = false;
+	stats.proxies--;
+}
+
+void SpatialHash::MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement)
+{
+	// The grid is rebuilt every step, so the tight bounds are all we need
+	proxies[proxy].aabb = aabb;
+}
+
+void SpatialHash::SetProxyStatic(int proxy, bool isStatic)
+{
+	proxies[proxy].isStatic = isStatic;
+}
+
+int SpatialHash::CellCoordinate(float x) const
+{
+	return (int)std::floor(x / cellSize);
+}
+
+int SpatialHash::HashCell(int cellX, int cellY, int numBuckets) const
+{
+	// Large primes spread neighbouring cells over the table, numBuckets is a power of 2
+	unsigned int h = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellY * 19349663u);
+	return h & (numBuckets - 1);
+}
+
+void SpatialHash::Rebuild()
+{
+	// Put every body in all the cells its AABB touches
+	entries.clear();
+	for (int proxy = 0; proxy < (int)proxies.size(); proxy++)
+	{
+		if (!proxies[proxy].isActive)
+		{
+			continue;
+		}
+
+		const AABB& aabb = proxies[proxy].aabb;
+		int x0 = CellCoordinate(aabb.min.x);
+		int y0 = CellCoordinate(aabb.min.y);
+		int x1 = CellCoordinate(aabb.max.x);
+		int y1 = CellCoordinate(aabb.max.y);
+
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				entries.push_back({ x, y, proxy, 0 });
+			}
+		}
+	}
+
+	// Use a table with at least twice as many buckets as entries to keep collisions low
+	int numBuckets = 1;
+	while (numBuckets < 2 * (int)entries.size())
+	{
+		numBuckets *= 2;
+	}
+
+	// Counting sort of the entries by bucket
+	bucketStart.assign(numBuckets + 1, 0);
+	for (auto& entry : entries)
+	{
+		entry.bucket = HashCell(entry.cellX, entry.cellY, numBuckets);
+		bucketStart[entry.bucket + 1]++;
+	}
+
+	for (int i = 0; i < numBuckets; i++)
+	{
+		bucketStart[i + 1] += bucketStart[i];
+	}
+
+	sortedEntries.resize(entries.size());
+	for (auto& entry : entries)
+	{
+		// bucketStart[bucket] is used as the insertion cursor and ends up at the start of the next bucket
+		sortedEntries[bucketStart[entry.bucket]++] = entry;
+	}
+
+	// Shift the cursors back so bucketStart[bucket] is the first entry of the bucket again
+	for (int i = numBuckets; i > 0; i--)
+	{
+		bucketStart[i] = bucketStart[i - 1];
+	}
+	bucketStart[0] = 0;
+}
+
+void SpatialHash::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+	pairs.clear();
+	stats.overlapTests = 0;
+
+	Rebuild();
+
+	const int numBuckets = bucketStart.size() - 1;
+	for (int bucket = 0; bucket < numBuckets; bucket++)
+	{
+		for (int i = bucketStart[bucket]; i < bucketStart[bucket + 1]; i++)
+		{
+			const Entry& e1 = sortedEntries[i];
+			const Proxy& p1 = proxies[e1.proxy];
+
+			for (int j = i + 1; j < bucketStart[bucket + 1]; j++)
+			{
+				const Entry& e2 = sortedEntries[j];
+				const Proxy& p2 = proxies[e2.proxy];
+
+				// Different cells can end up in the same bucket
+				if (e1.cellX != e2.cellX || e1.cellY != e2.cellY || e1.proxy == e2.proxy)
+				{
+					continue;
+				}
+
+				if (p1.isStatic && p2.isStatic)
+				{
+					continue;
+				}
+
+				stats.overlapTests++;
+				if (!p1.aabb.Overlaps(p2.aabb))
+				{
+					continue;
+				}
+
+				// Bodies can share several cells. Only report the pair in the cell
+				// that contains the min corner of the intersection of both AABBs.
+				int cellX = CellCoordinate(std::max(p1.aabb.min.x, p2.aabb.min.x));
+				int cellY = CellCoordinate(std::max(p1.aabb.min.y, p2.aabb.min.y));
+				if (cellX != e1.cellX || cellY != e1.cellY)
+				{
+					continue;
+				}
+
+				pairs.push_back({ std::min(e1.proxy, e2.proxy), std::max(e1.proxy, e2.proxy) });
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end(), ComparePairs);
+	stats.pairs = pairs.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sweep and prune (sort and sweep)
+///////////////////////////////////////////////////////////////////////////////
+BroadphaseType SweepAndPrune::GetType() const
+{
+	return SWEEP_AND_PRUNE;
+}
+
+void SweepAndPrune::CreateProxy(int proxy, const AABB& aabb, bool isStatic)
+{
+	if (proxy >= (int)proxies.size())
+	{
+		proxies.resize(proxy + 1, { AABB(), false, false });
+		openIndex.resize(proxy + 1, -1);
+	}
+	proxies[proxy] = { aabb, isStatic, true };
+
+	// The new endpoints are sorted into place by the next FindPairs()
+	endpoints.push_back({ aabb.min.x, proxy, true });
+	endpoints.push_back({ aabb.max.x, proxy, false });
+	stats.proxies++;
+}
+
+void SweepAndPrune::DestroyProxy(int proxy)
+{
+	proxies[proxy].isActive = false;
+
+	// Removing keeps the remaining endpoints sorted
+	endpoints.erase(
+		std::remove_if(endpoints.begin(), endpoints.end(), [proxy](const Endpoint& e) { return e.proxy == proxy; }),
+		endpoints.end()
+	);
+	stats.proxies--;
+}
+
+void SweepAndPrune::MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement)
+{
+	proxies[proxy].aabb = aabb;
+}
+
+void SweepAndPrune::SetProxyStatic(int proxy, bool isStatic)
+{
+	proxies[proxy].isStatic = isStatic;
+}
+
+// Endpoints are sorted by value. On a tie the min endpoints go first, so
+// touching intervals are still considered overlapping.
+bool SweepAndPrune::IsGreater(const Endpoint& e1, const Endpoint& e2)
+{
+	if (e1.value != e2.value)
+	{
+		return e1.value > e2.value;
+	}
+	return !e1.isMin && e2.isMin;
+}
+
+void SweepAndPrune::SortEndpoints()
+{
+	// Refresh the endpoint values with the current bounds
+	for (auto& endpoint : endpoints)
+	{
+		const AABB& aabb = proxies[endpoint.proxy].aabb;
+		endpoint.value = endpoint.isMin ? aabb.min.x : aabb.max.x;
+	}
+
+	// Insertion sort, the array is almost sorted from the previous step
+	stats.sortSwaps = 0;
+	for (int i = 1; i < (int)endpoints.size(); i++)
+	{
+		Endpoint key = endpoints[i];
+		int j = i - 1;
+		while (j >= 0 && IsGreater(endpoints[j], key))
+		{
+			endpoints[j + 1] = endpoints[j];
+			j--;
+			stats.sortSwaps++;
+		}
+		endpoints[j + 1] = key;
+	}
+}
+
+void SweepAndPrune::FindPairs(std::vector<BroadphasePair>& pairs)
+{
+	pairs.clear();
+	stats.overlapTests = 0;
+
+	SortEndpoints();
+
+	// Sweep along the x axis keeping the list of open intervals
+	open.clear();
+	for (auto& endpoint : endpoints)
+	{
+		int proxy = endpoint.proxy;
+
+		if (!endpoint.isMin)
+		{
+			// Close the interval (swap with the last open interval and pop)
+			int index = openIndex[proxy];
+			int last = open.back();
+			open[index] = last;
+			openIndex[last] = index;
+			open.pop_back();
+			openIndex[proxy] = -1;
+			continue;
+		}
+
+		// The x intervals of all the open proxies overlap this one, check the y axis
+		const Proxy& p1 = proxies[proxy];
+		for (int other : open)
+		{
+			const Proxy& p2 = proxies[other];
+			if (p1.isStatic && p2.isStatic)
+			{
+				continue;
+			}
+
+			stats.overlapTests++;
+			if (p1.aabb.min.y <= p2.aabb.max.y && p1.aabb.max.y >= p2.aabb.min.y)
+			{
+				pairs.push_back({ std::min(proxy, other), std::max(proxy, other) });
+			}
+		}
+
+		openIndex[proxy] = open.size();
+		open.push_back(proxy);
+	}
+
+	std::sort(pairs.begin(), pairs.end(), ComparePairs);
+	stats.pairs = pairs.size();
+}
@@ -0,0 +1,239 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "./AABB.h"
+
+#include <vector>
+
+enum BroadphaseType
+{
+	ALL_PAIRS,
+	AABB_TREE,
+	SPATIAL_HASH,
+	SWEEP_AND_PRUNE
+};
+
+// A pair of bodies (indices into the world's body list, a < b) whose bounds overlap
+struct BroadphasePair
+{
+	int a;
+	int b;
+};
+
+// Counters of the last FindPairs() call
+struct BroadphaseStats
+{
+	int proxies = 0;      // number of bodies tracked by the broadphase
+	int overlapTests = 0; // number of AABB vs AABB tests
+	int pairs = 0;        // number of pairs sent to the narrowphase
+	int sortSwaps = 0;    // number of swaps done to keep the sorted structures sorted
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Broadphase (abstract)
+///////////////////////////////////////////////////////////////////////////////
+// Keeps one proxy per body (indexed the same way as World::bodies) and
+// returns the pairs of bodies that might be colliding. Static vs static
+// pairs are never reported because they cannot produce a response. Sleeping
+// bodies are flagged as static too, so resting piles cost (almost) nothing.
+///////////////////////////////////////////////////////////////////////////////
+class Broadphase
+{
+protected:
+	BroadphaseStats stats;
+
+public:
+	virtual ~Broadphase() = default;
+	virtual BroadphaseType GetType() const = 0;
+
+	virtual void CreateProxy(int proxy, const AABB& aabb, bool isStatic) = 0;
+	virtual void DestroyProxy(int proxy) = 0;
+	virtual void MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement) = 0;
+	virtual void SetProxyStatic(int proxy, bool isStatic) = 0;
+	virtual void FindPairs(std::vector<BroadphasePair>& pairs) = 0;
+
+	const BroadphaseStats& GetStats() const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// All pairs
+///////////////////////////////////////////////////////////////////////////////
+// Reports every pair of bodies, O(n^2). Used as a reference to compare the
+// other broadphases against.
+///////////////////////////////////////////////////////////////////////////////
+class AllPairs : public Broadphase
+{
+private:
+	std::vector<int> proxyState; // -1 = no proxy, 0 = moving, 1 = static
+
+public:
+	AllPairs() = default;
+	~AllPairs() = default;
+	BroadphaseType GetType() const override;
+
+	void CreateProxy(int proxy, const AABB& aabb, bool isStatic) override;
+	void DestroyProxy(int proxy) override;
+	void MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement) override;
+	void SetProxyStatic(int proxy, bool isStatic) override;
+	void FindPairs(std::vector<BroadphasePair>& pairs) override;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Dynamic AABB tree
+///////////////////////////////////////////////////////////////////////////////
+// Bodies are stored in the leaves with "fat" bounds, so a body only needs to
+// be re-inserted when it leaves its fat AABB. The tree is kept balanced with
+// tree rotations, which keeps queries at O(log n).
+///////////////////////////////////////////////////////////////////////////////
+class AABBTree : public Broadphase
+{
+private:
+	struct Node
+	{
+		AABB aabb;
+		int parent;   // also the next free node while the node is in the free list
+		int child1;
+		int child2;
+		int height;   // 0 for leaves, -1 for free nodes
+		int proxy;    // body index for leaves, -1 for internal nodes
+		bool isStatic;
+
+		bool IsLeaf() const;
+	};
+
+	std::vector<Node> nodes;
+	int root = -1;
+	int freeList = -1;
+
+	std::vector<int> proxyToNode; // body index -> leaf node
+	std::vector<int> stack;       // traversal stack reused between queries
+
+	int AllocateNode();
+	void FreeNode(int node);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	void Refit(int index);
+	int Balance(int index);
+
+public:
+	// How much the AABBs are grown so that small motions don't touch the tree
+	static const float MARGIN;
+
+	// How far ahead the AABBs are extended in the direction of motion
+	static const float DISPLACEMENT_MULTIPLIER;
+
+	AABBTree() = default;
+	~AABBTree() = default;
+	BroadphaseType GetType() const override;
+
+	void CreateProxy(int proxy, const AABB& aabb, bool isStatic) override;
+	void DestroyProxy(int proxy) override;
+	void MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement) override;
+	void SetProxyStatic(int proxy, bool isStatic) override;
+	void FindPairs(std::vector<BroadphasePair>& pairs) override;
+
+	int GetHeight() const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Uniform spatial hash
+///////////////////////////////////////////////////////////////////////////////
+// Every body is put in the grid cells its AABB touches and only bodies that
+// share a cell are paired. The grid is rebuilt from scratch every step with
+// a counting sort over a hashed cell table, so memory is linear in the number
+// of bodies and the rebuild is O(n). Works best when the cell size is close
+// to the size of the bodies (e.g. lots of similar balls).
+///////////////////////////////////////////////////////////////////////////////
+class SpatialHash : public Broadphase
+{
+private:
+	struct Proxy
+	{
+		AABB aabb;
+		bool isStatic;
+		bool isActive;
+	};
+
+	struct Entry
+	{
+		int cellX;
+		int cellY;
+		int proxy;
+		int bucket;
+	};
+
+	float cellSize;
+	std::vector<Proxy> proxies;
+
+	std::vector<Entry> entries;       // one entry per (body, cell), unsorted
+	std::vector<Entry> sortedEntries; // entries grouped by hash bucket
+	std::vector<int> bucketStart;     // first sorted entry of every bucket
+
+	int CellCoordinate(float x) const;
+	int HashCell(int cellX, int cellY, int numBuckets) const;
+	void Rebuild();
+
+public:
+	// By default a cell is 2 meters wide
+	static const float DEFAULT_CELL_SIZE;
+
+	SpatialHash(float cellSize = DEFAULT_CELL_SIZE);
+	~SpatialHash() = default;
+	BroadphaseType GetType() const override;
+
+	void CreateProxy(int proxy, const AABB& aabb, bool isStatic) override;
+	void DestroyProxy(int proxy) override;
+	void MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement) override;
+	void SetProxyStatic(int proxy, bool isStatic) override;
+	void FindPairs(std::vector<BroadphasePair>& pairs) override;
+
+	float GetCellSize() const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Sweep and prune (sort and sweep)
+///////////////////////////////////////////////////////////////////////////////
+// Keeps the min/max endpoints of all the AABBs sorted along the x axis. The
+// array persists between steps and is re-sorted with an insertion sort, so
+// when bodies barely move (e.g. resting stacks) sorting is close to O(n).
+// The sweep then only pairs bodies whose x intervals overlap.
+///////////////////////////////////////////////////////////////////////////////
+class SweepAndPrune : public Broadphase
+{
+private:
+	struct Proxy
+	{
+		AABB aabb;
+		bool isStatic;
+		bool isActive;
+	};
+
+	struct Endpoint
+	{
+		float value;
+		int proxy;
+		bool isMin;
+	};
+
+	std::vector<Proxy> proxies;
+	std::vector<Endpoint> endpoints; // sorted along the x axis, persistent between steps
+
+	std::vector<int> open;      // proxies whose interval is open during the sweep
+	std::vector<int> openIndex; // position of every proxy in the open list
+
+	static bool IsGreater(const Endpoint& e1, const Endpoint& e2);
+	void SortEndpoints();
+
+public:
+	SweepAndPrune() = default;
+	~SweepAndPrune() = default;
+	BroadphaseType GetType() const override;
+
+	void CreateProxy(int proxy, const AABB& aabb, bool isStatic) override;
+	void DestroyProxy(int proxy) override;
+	void MoveProxy(int proxy, const AABB& aabb, const Vec2& displacement) override;
+	void SetProxyStatic(int proxy, bool isStatic) override;
+	void FindPairs(std::vector<BroadphasePair>& pairs) override;
+};
+
+#endif
@@ -1,44 +1,39 @@
 #include "CollisionDetection.h"
+#include "Constants.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
-
-bool CollisionDetection::IsColliding(Body* a, Body* b, std::vector<Contact>& contacts)
+#include <vector>
+
+// One entry for every pair of shape types: the row is the type of "a", the
+// column the type of "b". A new pair of shapes only needs its entry here
+static const CollisionFunction collisionFunctions[NUM_SHAPE_TYPES][NUM_SHAPE_TYPES] = {
+    //             CIRCLE                                        POLYGON                                        BOX
+    /* CIRCLE  */ { CollisionDetection::IsCollidingCircleCircle,  CollisionDetection::IsCollidingCirclePolygon,  CollisionDetection::IsCollidingCirclePolygon },
+    /* POLYGON */ { CollisionDetection::IsCollidingPolygonCircle, CollisionDetection::IsCollidingPolygonPolygon, CollisionDetection::IsCollidingPolygonPolygon },
+    /* BOX     */ { CollisionDetection::IsCollidingPolygonCircle, CollisionDetection::IsCollidingPolygonPolygon, CollisionDetection::IsCollidingBoxBox }
+};
+
+bool CollisionDetection::IsColliding(Body* a, Body* b, Contact* contacts, int& numContacts)
 {
-    bool aIsCircle = a->shape->GetType() == CIRCLE;
-    bool bIsCircle = b->shape->GetType() == CIRCLE;
-
-    bool aIsPolygon = a->shape->GetType() == POLYGON || a->shape->GetType() == BOX;
-    bool bIsPolygon = b->shape->GetType() == POLYGON || b->shape->GetType() == BOX;
-
-    if (aIsCircle && bIsCircle)
-    {
-        return IsCollidingCircleCircle(a, b, contacts);
-    }
-
-    if (aIsPolygon && bIsPolygon)
-    {
-        return IsCollidingPolygonPolygon(a, b, contacts);
-    }
-
-    if (aIsPolygon && bIsCircle) 
-    {
-        return IsCollidingPolygonCircle(a, b, contacts);
-    }
+    numContacts = 0;
 
-    if (aIsCircle && bIsPolygon) 
-    {
-        return IsCollidingPolygonCircle(b, a, contacts);
-    }
+    CollisionFunction isColliding = collisionFunctions[a->shape->GetType()][b->shape->GetType()];
+    return isColliding(a, b, contacts, numContacts);
+}
 
-    return false;
+CollisionFunction CollisionDetection::GetCollisionFunction(ShapeType a, ShapeType b)
+{
+    return collisionFunctions[a][b];
 }
 
-bool CollisionDetection::IsCollidingCircleCircle(Body* a, Body* b, std::vector<Contact>& contacts)
+bool CollisionDetection::IsCollidingCircleCircle(Body* a, Body* b, Contact* contacts, int& numContacts)
 {
     CircleShape* aCircleShape = (CircleShape*) a->shape;
     CircleShape* bCircleShape = (CircleShape*) b->shape;
 
-    const Vec2 ab = b->position - a->position;
+    const Vec2 ab = b->GetPosition() - a->GetPosition();
     const float radiusSum = aCircleShape->radius + bCircleShape->radius;
 
     bool isColliding = ab.MagnitudeSquared() <= (radiusSum * radiusSum);
@@ -58,138 +53,370 @@ bool CollisionDetection::IsCollidingCircleCircle(Body* a, Body* b, std::vector<C
     contact.normal = ab;
     contact.normal.Normalize();
 
-    contact.start = b->position - contact.normal * bCircleShape->radius;
-    contact.end = a->position + contact.normal * aCircleShape->radius;
+    contact.start = b->GetPosition() - contact.normal * bCircleShape->radius;
+    contact.end = a->GetPosition() + contact.normal * aCircleShape->radius;
 
     contact.depth = (contact.end - contact.start).Magnitude();
 
-    contacts.push_back(contact);
+    contacts[numContacts++] = contact;
 
     return true;
 }
 
-bool CollisionDetection::IsCollidingPolygonPolygon(Body* a, Body* b, std::vector<Contact>& contacts)
+// Moves the vertices of a polygon into the local space of another body. Boxes
+// and small polygons use the array on the stack, bigger ones a buffer of the
+// thread (the narrowphase runs on several threads) that keeps its memory
+static const Vec2* TransformVertices(const PolygonShape* shape, const Transform& transform, Vec2* buffer, int overflowIndex)
 {
-    PolygonShape* aPolygonShape = (PolygonShape*) a->shape;
-    PolygonShape* bPolygonShape = (PolygonShape*) b->shape;
+    Vec2* vertices = buffer;
+    if (shape->numVertices > PolygonShape::MAX_INLINE_VERTICES)
+    {
+        static thread_local std::vector<Vec2> overflow[2];
+        overflow[overflowIndex].resize(shape->numVertices);
+        vertices = overflow[overflowIndex].data();
+    }
 
-    int aIndexReferenceEdge, bIndexReferenceEdge;
-    Vec2 aSupportPoint, bSupportPoint;
+    for (int i = 0; i < shape->numVertices; i++)
+    {
+        vertices[i] = transform.Apply(shape->localVertices[i]);
+    }
+    return vertices;
+}
 
-    float abSeparation = aPolygonShape->FindMinSeparation(bPolygonShape, aIndexReferenceEdge, aSupportPoint);
-    if (abSeparation >= 0)
-	{
-        return false;
-	}
+// Clips the incident edge against every side of the reference polygon but the reference edge
+static void ClipToPolygonSides(const PolygonShape* referenceShape, int indexReferenceEdge, Vec2 contactPoints[2], Vec2 clippedPoints[2])
+{
+    for (int i = 0; i < referenceShape->numVertices; i++) 
+    {
+        if (i == indexReferenceEdge)
+        {
+           continue;
+        }
+        Vec2 c0 = referenceShape->localVertices[i];
+        Vec2 c1 = referenceShape->localVertices[(i + 1) % referenceShape->numVertices];
+        int numClipped = referenceShape->ClipSegmentToLine(contactPoints, clippedPoints, c0, c1);
+        if (numClipped < 2) 
+        {
+            break;
+        }
 
-    float baSeparation = bPolygonShape->FindMinSeparation(aPolygonShape, bIndexReferenceEdge, bSupportPoint);
-    if (baSeparation >= 0)
+        // make the next contact points the ones that were just clipped
+        contactPoints[0] = clippedPoints[0];
+        contactPoints[1] = clippedPoints[1];
+    }
+}
+
+// Same for a box: the sides are aligned with the axes of its local space, so
+// the distance of a point to a side is one of its coordinates minus a half
+// extent, without the edge directions to normalize
+static void ClipToBoxSides(const BoxShape* referenceShape, int indexReferenceEdge, Vec2 contactPoints[2], Vec2 clippedPoints[2])
+{
+    const float halfWidth = referenceShape->width * 0.5f;
+    const float halfHeight = referenceShape->height * 0.5f;
+
+    for (int i = 0; i < 4; i++)
     {
-        return false;
+        if (i == indexReferenceEdge)
+        {
+            continue;
+        }
+
+        // In the order of the edges of BoxShape: top, right, bottom, left
+        float dist[2];
+        for (int p = 0; p < 2; p++)
+        {
+            const Vec2& point = contactPoints[p];
+            switch (i)
+            {
+                case 0: dist[p] = -point.y - halfHeight; break;
+                case 1: dist[p] = point.x - halfWidth; break;
+                case 2: dist[p] = point.y - halfHeight; break;
+                default: dist[p] = -point.x - halfWidth; break;
+            }
+        }
+
+        int numClipped = PolygonShape::ClipSegment(contactPoints, clippedPoints, dist[0], dist[1]);
+        if (numClipped < 2)
+        {
+            break;
+        }
+
+        contactPoints[0] = clippedPoints[0];
+        contactPoints[1] = clippedPoints[1];
     }
+}
 
-    PolygonShape* referenceShape;
-    PolygonShape* incidentShape;
+// Creates the contacts of two overlapping polygons from the result of the
+// separating axis test on each of them: the reference edge is chosen from the
+// polygon with the largest separation and the incident edge of the other one is
+// clipped against its sides (in the local space of the reference polygon).
+// "areBoxes" tells that both shapes are BoxShape, which clip faster
+static void CreatePolygonContacts(Body* a, Body* b, const PolygonShape* aShape, const PolygonShape* bShape, const Transform& aTransform, const Transform& bTransform,
+    float abSeparation, int aIndexReferenceEdge, float baSeparation, int bIndexReferenceEdge, bool areBoxes, Contact* contacts, int& numContacts)
+{
+    const PolygonShape* referenceShape;
+    const PolygonShape* incidentShape;
+    Transform referenceTransform;
+    Transform incidentTransform;
     int indexReferenceEdge;
-    if (abSeparation > baSeparation)
+    // Prefer "A" as the reference shape unless "B" is clearly better. Without
+    // the tolerance, resting boxes keep swapping the reference shape between
+    // frames, which changes the contact features and breaks warm starting.
+    // It is a fixed bias toward "A", the choice of the last frame isn't kept
+    const float referenceTolerance = 0.01f * PIXELS_PER_METER; // 1 cm (0.5 px)
+    bool flip = baSeparation > abSeparation + referenceTolerance;
+    if (!flip)
     {
 	    // Set "A" as the reference shape
-        referenceShape = aPolygonShape;
+        referenceShape = aShape;
+        referenceTransform = aTransform;
 	    // Set "B" as the incident shape
-        incidentShape = bPolygonShape;
+        incidentShape = bShape;
+        incidentTransform = bTransform;
         // Set the indexReference edge to whichever one is greater
         indexReferenceEdge = aIndexReferenceEdge;
     }
     else
     {
         // Set "B" as the reference shape
-        referenceShape = bPolygonShape;
+        referenceShape = bShape;
+        referenceTransform = bTransform;
         // Set "A" as the incident shape
-        incidentShape = aPolygonShape;
+        incidentShape = aShape;
+        incidentTransform = aTransform;
         // Set the indexReference edge to whichever one is greater
         indexReferenceEdge = bIndexReferenceEdge;
     }
 
-    // Find the reference edge based on the index that is returned from the function
-    Vec2 referenceEdge = referenceShape->EdgeAt(indexReferenceEdge);
+    // Find the normal of the reference edge based on the index that is returned from the function
+    const Vec2 referenceNormal = referenceShape->localNormals[indexReferenceEdge];
+    const Vec2 worldNormal = referenceTransform.rotation.Rotate(referenceNormal);
 
 
     ///////////////////////////////////// 
 	// Clipping 
 	/////////////////////////////////////
-    // Find the incident edge
-    int incidentIndex = incidentShape->FindIncidentEdge(referenceEdge.Normal());
-    int incidentNextIndex = (incidentIndex + 1) % incidentShape->worldVertices.size();
-    Vec2 v0 = incidentShape->worldVertices[incidentIndex];
-    Vec2 v1 = incidentShape->worldVertices[incidentNextIndex];
-
-    std::vector<Vec2> contactPoints = { v0, v1 };
-    std::vector<Vec2> clippedPoints = contactPoints;
-    for (int i = 0; i < referenceShape->worldVertices.size(); i++) 
+    // Find the incident edge (the normals of the incident shape are in its own local space)
+    int incidentIndex = incidentShape->FindIncidentEdge(incidentTransform.rotation.InverseRotate(worldNormal));
+    int incidentNextIndex = (incidentIndex + 1) % incidentShape->numVertices;
+    const Transform incidentInReference = referenceTransform.Relative(incidentTransform);
+    Vec2 v0 = incidentInReference.Apply(incidentShape->localVertices[incidentIndex]);
+    Vec2 v1 = incidentInReference.Apply(incidentShape->localVertices[incidentNextIndex]);
+
+    // A segment clipped by a line keeps at most 2 points, so they fit in fixed arrays
+    Vec2 contactPoints[2] = { v0, v1 };
+    Vec2 clippedPoints[2] = { v0, v1 };
+    if (areBoxes)
     {
-        if (i == indexReferenceEdge)
-        {
-           continue;
-        }
-        Vec2 c0 = referenceShape->worldVertices[i];
-        Vec2 c1 = referenceShape->worldVertices[(i + 1) % referenceShape->worldVertices.size()];
-        int numClipped = referenceShape->ClipSegmentToLine(contactPoints, clippedPoints, c0, c1);
-        if (numClipped < 2) 
-        {
-            break;
-        }
-
-        contactPoints = clippedPoints; // make the next contact points the ones that were just clipped
+        ClipToBoxSides((const BoxShape*) referenceShape, indexReferenceEdge, contactPoints, clippedPoints);
+    }
+    else
+    {
+        ClipToPolygonSides(referenceShape, indexReferenceEdge, contactPoints, clippedPoints);
     }
 
     // Get the vertex of the reference edge
-    auto vref = referenceShape->worldVertices[indexReferenceEdge];
+    auto vref = referenceShape->localVertices[indexReferenceEdge];
 
     // Loop all clipped points, but only consider those where separation is negative (objects are penetrating each other)
-    for (auto& vclip : clippedPoints) 
+    for (int i = 0; i < 2; i++) 
     {
-        float separation = (vclip - vref).Dot(referenceEdge.Normal());
+        const Vec2& vclip = clippedPoints[i];
+        float separation = (vclip - vref).Dot(referenceNormal);
         if (separation <= 0) 
         {
+            // Only the contacts go back to world space
             Contact contact;
             contact.a = a;
             contact.b = b;
-            contact.normal = referenceEdge.Normal();
-            contact.start = vclip;
-            contact.end = vclip + contact.normal * -separation;
-            if (baSeparation >= abSeparation) 
+            contact.normal = worldNormal;
+            contact.start = referenceTransform.Apply(vclip);
+            contact.end = contact.start + contact.normal * -separation;
+
+            // Feature: which shape is the reference, reference edge, incident edge and clipped point
+            contact.feature = (flip << 24) | (indexReferenceEdge << 16) | (incidentIndex << 8) | i;
+
+            if (flip)
             {
                 std::swap(contact.start, contact.end); // the start-end points are always from "a" to "b"
                 contact.normal *= -1.0;                                // the collision normal is always from "a" to "b"
             }
 
-            contacts.push_back(contact);
+            contacts[numContacts++] = contact;
         }
     }
+}
+
+bool CollisionDetection::IsCollidingPolygonPolygon(Body* a, Body* b, Contact* contacts, int& numContacts)
+{
+    return IsCollidingPolygonPolygon(a, b, contacts, numContacts, HILL_CLIMBING_MIN_VERTICES);
+}
+
+bool CollisionDetection::IsCollidingPolygonPolygon(Body* a, Body* b, Contact* contacts, int& numContacts, int hillClimbingMinVertices)
+{
+    PolygonShape* aPolygonShape = (PolygonShape*) a->shape;
+    PolygonShape* bPolygonShape = (PolygonShape*) b->shape;
+
+    const Transform aTransform = a->GetTransform();
+    const Transform bTransform = b->GetTransform();
+
+    // Cheap test first: the polygons can't touch if their bounding circles don't
+    const Vec2 ab = bTransform.position - aTransform.position;
+    const float radiusSum = aPolygonShape->boundingRadius + bPolygonShape->boundingRadius;
+    if (ab.MagnitudeSquared() > radiusSum * radiusSum)
+    {
+        return false;
+    }
+
+    // The separating axis test runs in the local space of each polygon, with
+    // the vertices of the other one moved into it
+    Vec2 bBuffer[PolygonShape::MAX_INLINE_VERTICES];
+    Vec2 aBuffer[PolygonShape::MAX_INLINE_VERTICES];
+
+    int aIndexReferenceEdge, bIndexReferenceEdge;
+    Vec2 aSupportPoint, bSupportPoint;
+
+    // Big polygons walk along the vertices of the other one instead of checking all of them for every edge
+    const bool hillClimbing = std::max(aPolygonShape->numVertices, bPolygonShape->numVertices) >= hillClimbingMinVertices;
+
+    float abSeparation;
+    const Vec2* bVerticesInA = TransformVertices(bPolygonShape, aTransform.Relative(bTransform), bBuffer, 0);
+    if (hillClimbing)
+    {
+        abSeparation = aPolygonShape->FindMinSeparationHillClimbing(bVerticesInA, bPolygonShape->numVertices, aIndexReferenceEdge, aSupportPoint);
+    }
+    else
+    {
+        abSeparation = aPolygonShape->FindMinSeparation(bVerticesInA, bPolygonShape->numVertices, aIndexReferenceEdge, aSupportPoint);
+    }
+    if (abSeparation >= 0)
+	{
+        return false;
+	}
+
+    float baSeparation;
+    const Vec2* aVerticesInB = TransformVertices(aPolygonShape, bTransform.Relative(aTransform), aBuffer, 1);
+    if (hillClimbing)
+    {
+        baSeparation = bPolygonShape->FindMinSeparationHillClimbing(aVerticesInB, aPolygonShape->numVertices, bIndexReferenceEdge, bSupportPoint);
+    }
+    else
+    {
+        baSeparation = bPolygonShape->FindMinSeparation(aVerticesInB, aPolygonShape->numVertices, bIndexReferenceEdge, bSupportPoint);
+    }
+    if (baSeparation >= 0)
+    {
+        return false;
+    }
+
+    CreatePolygonContacts(a, b, aPolygonShape, bPolygonShape, aTransform, bTransform, abSeparation, aIndexReferenceEdge, baSeparation, bIndexReferenceEdge, false, contacts, numContacts);
     return true;
 }
 
-bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, std::vector<Contact>& contacts)
+// Separating axis test of a box against another box, in the local space of the
+// first one. Same result as PolygonShape::FindMinSeparation(), but the faces of
+// a box only have two directions, so the deepest vertex of the other box along
+// each of them comes from its half extents instead of a loop over its vertices
+static float FindBoxSeparation(const BoxShape* box, const BoxShape* other, const Transform& otherInBox, int& indexReferenceEdge)
+{
+    const float halfWidth = box->width * 0.5f;
+    const float halfHeight = box->height * 0.5f;
+
+    // Half extents of the other box projected on the two axes
+    const float c = std::abs(otherInBox.rotation.c);
+    const float s = std::abs(otherInBox.rotation.s);
+    const float otherHalfWidth = other->width * 0.5f;
+    const float otherHalfHeight = other->height * 0.5f;
+    const float extentX = otherHalfWidth * c + otherHalfHeight * s;
+    const float extentY = otherHalfWidth * s + otherHalfHeight * c;
+
+    // In the order of the edges of BoxShape: top (0, -1), right (1, 0), bottom (0, 1), left (-1, 0)
+    const Vec2& center = otherInBox.position;
+    const float separations[4] = {
+        -center.y - halfHeight - extentY,
+        center.x - halfWidth - extentX,
+        center.y - halfHeight - extentY,
+        -center.x - halfWidth - extentX
+    };
+
+    // Like the loop over the edges, the first one wins ties
+    indexReferenceEdge = 0;
+    for (int i = 1; i < 4; i++)
+    {
+        if (separations[i] > separations[indexReferenceEdge])
+        {
+            indexReferenceEdge = i;
+        }
+    }
+    return separations[indexReferenceEdge];
+}
+
+bool CollisionDetection::IsCollidingBoxBox(Body* a, Body* b, Contact* contacts, int& numContacts)
+{
+    BoxShape* aBoxShape = (BoxShape*) a->shape;
+    BoxShape* bBoxShape = (BoxShape*) b->shape;
+
+    const Transform aTransform = a->GetTransform();
+    const Transform bTransform = b->GetTransform();
+
+    // Cheap test first: the boxes can't touch if their bounding circles don't
+    const Vec2 ab = bTransform.position - aTransform.position;
+    const float radiusSum = aBoxShape->boundingRadius + bBoxShape->boundingRadius;
+    if (ab.MagnitudeSquared() > radiusSum * radiusSum)
+    {
+        return false;
+    }
+
+    // The separating axes are the two axes of each box
+    int aIndexReferenceEdge, bIndexReferenceEdge;
+    float abSeparation = FindBoxSeparation(aBoxShape, bBoxShape, aTransform.Relative(bTransform), aIndexReferenceEdge);
+    if (abSeparation >= 0)
+    {
+        return false;
+    }
+
+    float baSeparation = FindBoxSeparation(bBoxShape, aBoxShape, bTransform.Relative(aTransform), bIndexReferenceEdge);
+    if (baSeparation >= 0)
+    {
+        return false;
+    }
+
+    CreatePolygonContacts(a, b, aBoxShape, bBoxShape, aTransform, bTransform, abSeparation, aIndexReferenceEdge, baSeparation, bIndexReferenceEdge, true, contacts, numContacts);
+    return true;
+}
+
+bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, Contact* contacts, int& numContacts)
 {
     const PolygonShape* polygonShape = (PolygonShape*)polygon->shape;
     const CircleShape* circleShape = (CircleShape*)circle->shape;
-    const std::vector<Vec2>& polygonVertices = polygonShape->worldVertices;
+
+    // Everything is checked in the local space of the polygon, only the contact goes back to world space
+    const Transform polygonTransform = polygon->GetTransform();
+    const Vec2 center = polygonTransform.ApplyInverse(circle->GetPosition());
+    const Vec2* polygonVertices = polygonShape->localVertices;
+
+    // Cheap test first: the circle can't touch the polygon if it doesn't touch its bounding circle
+    const float radiusSum = polygonShape->boundingRadius + circleShape->radius;
+    if (center.MagnitudeSquared() > radiusSum * radiusSum)
+    {
+        return false;
+    }
 
     bool isOutside = false;
+    int minEdgeIndex = 0;
     Vec2 minCurrVertex;
     Vec2 minNextVertex;
     float distanceCircleEdge = std::numeric_limits<float>::lowest();
 
     // Loop all the edges of the polygon/box finding the nearest edge to the circle center
-    for (int i = 0; i < polygonVertices.size(); i++) 
+    for (int i = 0; i < polygonShape->numVertices; i++) 
     {
         int currVertex = i;
-        int nextVertex = (i + 1) % polygonVertices.size();
-        Vec2 edge = polygonShape->EdgeAt(currVertex);
-        Vec2 normal = edge.Normal();
+        int nextVertex = (i + 1) % polygonShape->numVertices;
+        const Vec2& normal = polygonShape->localNormals[currVertex];
 
         // Compare the circle center with the rectangle vertex
-        Vec2 vertexToCircleCenter = circle->position - polygonVertices[currVertex];
+        Vec2 vertexToCircleCenter = center - polygonVertices[currVertex];
         float projection = vertexToCircleCenter.Dot(normal);
 
         // If found a dot product projection that is in the positive/outside side of the normal
@@ -197,6 +424,7 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
         {
             // Circle center is outside the polygon
             distanceCircleEdge = projection;
+            minEdgeIndex = currVertex;
             minCurrVertex = polygonVertices[currVertex];
             minNextVertex = polygonVertices[nextVertex];
             isOutside = true;
@@ -208,6 +436,7 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
             if (projection > distanceCircleEdge) 
             {
                 distanceCircleEdge = projection;
+                minEdgeIndex = currVertex;
                 minCurrVertex = polygonVertices[currVertex];
                 minNextVertex = polygonVertices[nextVertex];
             }
@@ -220,7 +449,7 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
         ///////////////////////////////////////
         // Check if we are inside region A:
         ///////////////////////////////////////
-        Vec2 v1 = circle->position - minCurrVertex; // vector from the nearest vertex to the circle center
+        Vec2 v1 = center - minCurrVertex; // vector from the nearest vertex to the circle center
         Vec2 v2 = minNextVertex - minCurrVertex; // the nearest edge (from curr vertex to next vertex)
         if (v1.Dot(v2) < 0) 
         {
@@ -236,7 +465,7 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
                 contact.b = circle;
                 contact.depth = circleShape->radius - v1.Magnitude();
                 contact.normal = v1.Normalize();
-                contact.start = circle->position + (contact.normal * -circleShape->radius);
+                contact.start = center + (contact.normal * -circleShape->radius);
                 contact.end = contact.start + (contact.normal * contact.depth);
             }
         }
@@ -244,7 +473,7 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
             ///////////////////////////////////////
             // Check if we are inside region B:
             ///////////////////////////////////////
-            v1 = circle->position - minNextVertex; // vector from the next nearest vertex to the circle center
+            v1 = center - minNextVertex; // vector from the next nearest vertex to the circle center
             v2 = minCurrVertex - minNextVertex;   // the nearest edge
             if (v1.Dot(v2) < 0) 
             {
@@ -260,7 +489,7 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
                     contact.b = circle;
                     contact.depth = circleShape->radius - v1.Magnitude();
                     contact.normal = v1.Normalize();
-                    contact.start = circle->position + (contact.normal * -circleShape->radius);
+                    contact.start = center + (contact.normal * -circleShape->radius);
                     contact.end = contact.start + (contact.normal * contact.depth);
                 }
             }
@@ -281,7 +510,7 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
                     contact.b = circle;
                     contact.depth = circleShape->radius - distanceCircleEdge;
                     contact.normal = (minNextVertex - minCurrVertex).Normal();
-                    contact.start = circle->position - (contact.normal * circleShape->radius);
+                    contact.start = center - (contact.normal * circleShape->radius);
                     contact.end = contact.start + (contact.normal * contact.depth);
                 }
             }
@@ -294,11 +523,24 @@ bool CollisionDetection::IsCollidingPolygonCircle(Body* polygon, Body* circle, s
         contact.b = circle;
         contact.depth = circleShape->radius - distanceCircleEdge;
         contact.normal = (minNextVertex - minCurrVertex).Normal();
-        contact.start = circle->position - (contact.normal * circleShape->radius);
+        contact.start = center - (contact.normal * circleShape->radius);
         contact.end = contact.start + (contact.normal * contact.depth);
     }
 
-    contacts.push_back(contact);
+    // Feature: the polygon edge closest to the circle
+    contact.feature = minEdgeIndex;
+
+    contact.normal = polygonTransform.rotation.Rotate(contact.normal);
+    contact.start = polygonTransform.Apply(contact.start);
+    contact.end = polygonTransform.Apply(contact.end);
+
+    contacts[numContacts++] = contact;
 
     return true;
 }
+
+bool CollisionDetection::IsCollidingCirclePolygon(Body* circle, Body* polygon, Contact* contacts, int& numContacts)
+{
+    // The contact goes from the polygon to the circle
+    return IsCollidingPolygonCircle(polygon, circle, contacts, numContacts);
+}
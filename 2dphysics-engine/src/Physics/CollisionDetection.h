@@ -4,12 +4,31 @@
 #include "./Body.h"
 #include "./Contact.h"
 
+// Collision test between two bodies with known shape types
+typedef bool (*CollisionFunction)(Body* a, Body* b, Contact* contacts, int& numContacts);
+
+// The functions write the contacts they find (at most MAX_CONTACTS_PER_PAIR)
+// to "contacts" and their number to "numContacts"
 struct CollisionDetection
 {
-	static bool IsColliding(Body* a, Body* b, std::vector<Contact>& contacts);
-	static bool IsCollidingCircleCircle(Body* a, Body* b, std::vector<Contact>& contacts);
-	static bool IsCollidingPolygonPolygon(Body* a, Body* b, std::vector<Contact>& contacts);
-	static bool IsCollidingPolygonCircle(Body* polygon, Body* circle, std::vector<Contact>& contacts);
+	// Calls the function of the table for the shape types of "a" and "b"
+	static bool IsColliding(Body* a, Body* b, Contact* contacts, int& numContacts);
+	static CollisionFunction GetCollisionFunction(ShapeType a, ShapeType b);
+
+	static bool IsCollidingCircleCircle(Body* a, Body* b, Contact* contacts, int& numContacts);
+	static bool IsCollidingPolygonPolygon(Body* a, Body* b, Contact* contacts, int& numContacts);
+	static bool IsCollidingBoxBox(Body* a, Body* b, Contact* contacts, int& numContacts);
+	static bool IsCollidingPolygonCircle(Body* polygon, Body* circle, Contact* contacts, int& numContacts);
+	static bool IsCollidingCirclePolygon(Body* circle, Body* polygon, Contact* contacts, int& numContacts);
+
+	// Polygon pairs where one of the polygons has at least this many vertices
+	// find their separating axis by hill climbing (O(n + m)) instead of
+	// checking every vertex against every edge (O(n * m)). Both find the same
+	// contacts, the walk only pays off with more than a handful of vertices
+	static const int HILL_CLIMBING_MIN_VERTICES = 8;
+
+	// The polygon test with another threshold, to compare both searches (./benchmark hillclimb)
+	static bool IsCollidingPolygonPolygon(Body* a, Body* b, Contact* contacts, int& numContacts, int hillClimbingMinVertices);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "Coloring.h"
+
+void ConstraintColoring::Build(Constraint* const* constraints, int count, int numBodies)
+{
+	if ((int)bodyColors.size() < numBodies)
+	{
+		bodyColors.resize(numBodies, 0);
+	}
+
+	// Pick the first color that none of the two bodies uses yet
+	constraintColors.resize(count);
+	int numColors = 0;
+	for (int i = 0; i < count; i++)
+	{
+		const Body* a = constraints[i]->a;
+		const Body* b = constraints[i]->b;
+		uint64_t used = 0;
+		if (!a->IsStatic())
+		{
+			used |= bodyColors[a->index];
+		}
+		if (!b->IsStatic())
+		{
+			used |= bodyColors[b->index];
+		}
+
+		int color = MAX_COLORS; // overflow
+		for (int c = 0; c < MAX_COLORS; c++)
+		{
+			if ((used & ((uint64_t)1 << c)) == 0)
+			{
+				color = c;
+				break;
+			}
+		}
+
+		if (color < MAX_COLORS)
+		{
+			if (!a->IsStatic())
+			{
+				bodyColors[a->index] |= (uint64_t)1 << color;
+			}
+			if (!b->IsStatic())
+			{
+				bodyColors[b->index] |= (uint64_t)1 << color;
+			}
+			if (color + 1 > numColors)
+			{
+				numColors = color + 1;
+			}
+		}
+		constraintColors[i] = color;
+	}
+
+	// Clear the masks for the next call (only the bodies that were touched)
+	for (int i = 0; i < count; i++)
+	{
+		bodyColors[constraints[i]->a->index] = 0;
+		bodyColors[constraints[i]->b->index] = 0;
+	}
+
+	// Group the constraints by color, the overflow group goes right after the last color
+	colorStart.assign(numColors + 2, 0);
+	for (int i = 0; i < count; i++)
+	{
+		int color = constraintColors[i] == MAX_COLORS ? numColors : constraintColors[i];
+		colorStart[color + 1]++;
+	}
+	for (int c = 0; c <= numColors; c++)
+	{
+		colorStart[c + 1] += colorStart[c];
+	}
+
+	coloredConstraints.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		int color = constraintColors[i] == MAX_COLORS ? numColors : constraintColors[i];
+		coloredConstraints[colorStart[color]++] = i;
+	}
+	for (int c = numColors + 1; c > 0; c--)
+	{
+		colorStart[c] = colorStart[c - 1];
+	}
+	colorStart[0] = 0;
+}
+
+int ConstraintColoring::GetNumColors() const
+{
+	return colorStart.size() - 2;
+}
+
+const int* ConstraintColoring::GetColor(int color, int& count) const
+{
+	count = colorStart[color + 1] - colorStart[color];
+	return coloredConstraints.data() + colorStart[color];
+}
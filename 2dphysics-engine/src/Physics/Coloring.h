@@ -0,0 +1,47 @@
+#ifndef COLORING_H
+#define COLORING_H
+
+#include "./Constraint.h"
+
+#include <cstdint>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// ConstraintColoring
+///////////////////////////////////////////////////////////////////////////////
+// Splits a list of constraints into colors so that two constraints of the
+// same color never share a dynamic body. The constraints of a color can then
+// be solved in parallel without locks, one color after the other. Static
+// bodies are never written by the solver, so they don't count.
+//
+// Greedy coloring in the order of the list, with a bit mask of used colors
+// per body. Constraints that don't fit in MAX_COLORS go to an overflow group
+// that must be solved serially. The colors only depend on the order of the
+// list, never on the number of threads.
+///////////////////////////////////////////////////////////////////////////////
+class ConstraintColoring
+{
+private:
+	std::vector<uint64_t> bodyColors;     // colors already used by every body, indexed by body index
+	std::vector<int> colorStart;          // first constraint of every color (the last group is the overflow)
+	std::vector<int> coloredConstraints;  // constraint indices grouped by color
+	std::vector<int> constraintColors;    // color of every constraint (scratch)
+
+public:
+	static const int MAX_COLORS = 64;
+
+	ConstraintColoring() = default;
+	~ConstraintColoring() = default;
+
+	// Colors the constraints, numBodies is the size of the world's list of bodies
+	void Build(Constraint* const* constraints, int count, int numBodies);
+
+	// Number of colors used, without the overflow group
+	int GetNumColors() const;
+
+	// Indices (into the list given to Build()) of the constraints of a color, or
+	// of the overflow group when color == GetNumColors()
+	const int* GetColor(int color, int& count) const;
+};
+
+#endif
@@ -1,9 +1,20 @@
 #ifndef CONSTANTS_H
 #define CONSTANTS_H
 
+// Default rates of the app, independent of each other: the frames drawn and
+// the fixed steps of the physics per second
 const int FPS = 60;
-const int MILLISECS_PER_FRAME = 1000 / FPS;
+const int PHYSICS_STEPS_PER_SECOND = 60;
+
+// Steps a frame runs at most. When stepping is slower than real time the time
+// left is dropped, instead of running more steps every frame to catch up
+const int MAX_STEPS_PER_FRAME = 5;
 
 const int PIXELS_PER_METER = 50;
 
+// A body can fall asleep once it has been slower than these tolerances for TIME_TO_SLEEP seconds
+const float LINEAR_SLEEP_TOLERANCE = 0.05f * PIXELS_PER_METER; // pixels per second
+const float ANGULAR_SLEEP_TOLERANCE = 0.05f;                   // radians per second
+const float TIME_TO_SLEEP = 0.5f;                              // seconds
+
 #endif
\ No newline at end of file
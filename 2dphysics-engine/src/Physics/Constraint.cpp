@@ -1,9 +1,19 @@
 ﻿#include "Constraint.h"
+#include "Constants.h"
 
 #include <algorithm>
 
+// Inverse of a diagonal entry of J * invM * Jt, zero when the row can't
+// move anything (e.g. both bodies are static or the row is empty)
+static float InverseOrZero(float value)
+{
+	return (value != 0.0f) ? 1.0f / value : 0.0f;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
-// Mat6x6 with the all inverse mass and inverse I of bodies "a" and "b"
+// Diagonal of the Mat6x6 with the all inverse mass and inverse I of bodies
+// "a" and "b". Every other entry of the matrix is zero, so only the diagonal
+// is stored and the solver multiplies by it directly.
 ///////////////////////////////////////////////////////////////////////////////
 //  [ 1/ma  0     0     0     0     0    ]
 //  [ 0     1/ma  0     0     0     0    ]
@@ -12,25 +22,23 @@
 //  [ 0     0     0     0     1/mb  0    ]
 //  [ 0     0     0     0     0     1/Ib ]
 ///////////////////////////////////////////////////////////////////////////////
-MatMN Constraint::GetInvM() const
+Vec<6> Constraint::GetInvM() const
 {
-	MatMN invM(6, 6);
+	Vec<6> invM;
 
-	invM.Zero();
+	invM[0] = a->GetInvMass();
+	invM[1] = a->GetInvMass();
+	invM[2] = a->GetInvI();
 
-	invM.rows[0][0] = a->invMass;
-	invM.rows[1][1] = a->invMass;
-	invM.rows[2][2] = a->invI;
-
-	invM.rows[3][3] = b->invMass;
-	invM.rows[4][4] = b->invMass;
-	invM.rows[5][5] = b->invI;
+	invM[3] = b->GetInvMass();
+	invM[4] = b->GetInvMass();
+	invM[5] = b->GetInvI();
 
 	return invM;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// VecN with the all linear and angular velocities of bodies "a" and "b"
+// Vec6 with the all linear and angular velocities of bodies "a" and "b"
 ///////////////////////////////////////////////////////////////////////////////
 //  [ va.x ]
 //  [ va.y ]
@@ -39,29 +47,49 @@ MatMN Constraint::GetInvM() const
 //  [ vb.y ]
 //  [ ωb   ]
 ///////////////////////////////////////////////////////////////////////////////
-VecN Constraint::GetVelocities() const
+Vec<6> Constraint::GetVelocities() const
 {
-	VecN V(6);
-
-	V.Zero();
+	Vec<6> V;
 
-	V[0] = a->velocity.x;
-	V[1] = a->velocity.y;
-	V[2] = a->angularVelocity;
+	V[0] = a->GetVelocity().x;
+	V[1] = a->GetVelocity().y;
+	V[2] = a->GetAngularVelocity();
 
-	V[3] = b->velocity.x;
-	V[4] = b->velocity.y;
-	V[5] = b->angularVelocity;
+	V[3] = b->GetVelocity().x;
+	V[4] = b->GetVelocity().y;
+	V[5] = b->GetAngularVelocity();
 
 	return V;
 }
 
-JointConstraint::JointConstraint() : Constraint(), jacobian(1, 6), cachedLambda(1), bias(0.0f)
+// Never destroyed, objects may still be deleted by static destructors at exit
+static Pool& JointConstraintPool()
+{
+	static Pool* pool = new Pool(sizeof(JointConstraint));
+	return *pool;
+}
+
+void* JointConstraint::operator new(std::size_t size)
+{
+	return AllocateFromPool(JointConstraintPool(), size);
+}
+
+void JointConstraint::operator delete(void* block, std::size_t size)
+{
+	FreeToPool(JointConstraintPool(), block, size);
+}
+
+const PoolStats& JointConstraint::GetPoolStats()
+{
+	return JointConstraintPool().GetStats();
+}
+
+JointConstraint::JointConstraint() : Constraint(), bias(0.0f), effectiveMass(0.0f)
 {
 	cachedLambda.Zero();
 }
 
-JointConstraint::JointConstraint(Body* a, Body* b, const Vec2& anchorPoint) : Constraint(), jacobian(1, 6), cachedLambda(1), bias(0.0f)
+JointConstraint::JointConstraint(Body* a, Body* b, const Vec2& anchorPoint) : Constraint(), bias(0.0f), effectiveMass(0.0f)
 {
 	this->a = a;
 	this->b = b;
@@ -79,8 +107,8 @@ void JointConstraint::PreSolve(const float dt)
 	const Vec2 pa = a->LocalSpaceToWorldSpace(aPoint);
 	const Vec2 pb = b->LocalSpaceToWorldSpace(bPoint);
 
-	const Vec2 ra = pa - a->position;
-	const Vec2 rb = pb - b->position;
+	const Vec2 ra = pa - a->GetPosition();
+	const Vec2 rb = pb - b->GetPosition();
 
 	jacobian.Zero();
 
@@ -101,10 +129,14 @@ void JointConstraint::PreSolve(const float dt)
 	float J4 = rb.Cross(pb - pa) * 2.0;
 	jacobian.rows[0][5] = J4;   // B angular velocity
 
+	// The Jacobian and the masses don't change until PostSolve(), so the
+	// effective mass is computed only once instead of on every Solve() call
+	const Mat<1, 1> lhs = jacobian.MultiplyDiagonalTranspose(GetInvM());
+	effectiveMass = InverseOrZero(lhs.rows[0][0]);
+
 	// Before anything else, apply the cachedLambda from the previous Solve() call
 	// This is the warm-starting technique
-	const MatMN Jt = jacobian.Transpose();
-	VecN impulses = Jt * cachedLambda;
+	const Vec<6> impulses = jacobian.TransposeMultiply(cachedLambda);
 
 	// Apply the impulses to both A & B
 	a->ApplyImpulseLinear(Vec2(impulses[0], impulses[1])); // A linear impulse
@@ -125,23 +157,16 @@ void JointConstraint::PreSolve(const float dt)
 
 void JointConstraint::Solve()
 {
-	const VecN V = GetVelocities();
-	const MatMN invM = GetInvM();
-
-	const MatMN J = jacobian;
-	const MatMN Jt = jacobian.Transpose();
+	const Vec<6> V = GetVelocities();
 
-	// Compute lambda using Ax = b (Gauss-Seidel method)
+	// Compute lambda using Ax = b, with A = J * invM * Jt precomputed in PreSolve()
 	// Lambda being the magnitude of the impulses
-	MatMN lhs = J * invM * Jt; // A (left hand side)
-	VecN rhs = J * V * -1.0f;  // b (right hand side)
-	rhs[0] -= bias;
-
-	VecN lambda = MatMN::SolveGaussSeidel(lhs, rhs);
+	Vec<1> lambda;
+	lambda[0] = (-jacobian.rows[0].Dot(V) - bias) * effectiveMass;
 	cachedLambda += lambda;
 
 	// Compute the final impulses with direction and magnitude
-	VecN impulses = Jt * lambda;
+	Vec<6> impulses = jacobian.TransposeMultiply(lambda);
 
 	// Apply the impulses to both A & B
 	a->ApplyImpulseLinear(Vec2(impulses[0], impulses[1])); // A linear impulse
@@ -157,13 +182,13 @@ void JointConstraint::PostSolve()
 }
 
 // Penetration Constraints
-PenetrationConstraint::PenetrationConstraint() : Constraint(), jacobian(2, 6), cachedLambda(2), bias(0.0f)
+PenetrationConstraint::PenetrationConstraint() : Constraint(), bias(0.0f), normalMass(0.0f), tangentMass(0.0f), feature(0)
 {
 	cachedLambda.Zero();
 	friction = 0.0f;
 }
 
-PenetrationConstraint::PenetrationConstraint(Body* a, Body* b, const Vec2& aCollisionPoint, const Vec2& bCollisionPoint, const Vec2& normal) : Constraint(), jacobian(2, 6), cachedLambda(2), bias(0.0f)
+PenetrationConstraint::PenetrationConstraint(Body* a, Body* b, const Vec2& aCollisionPoint, const Vec2& bCollisionPoint, const Vec2& normal, int feature) : Constraint(), bias(0.0f), normalMass(0.0f), tangentMass(0.0f), feature(feature)
 {
 	this->a = a;
 	this->b = b;
@@ -172,22 +197,36 @@ PenetrationConstraint::PenetrationConstraint(Body* a, Body* b, const Vec2& aColl
 	this->aPoint = a->WorldSpaceToLocalSpace(aCollisionPoint);
 	this->bPoint = b->WorldSpaceToLocalSpace(bCollisionPoint);
 
-	// Convert normal vector to local space
-	this->normal = a->WorldSpaceToLocalSpace(normal);
+	// Convert normal vector to local space (it's a direction, so it's only rotated)
+	this->normal = a->GetTransform().rotation.InverseRotate(normal);
 
 	cachedLambda.Zero();
 	friction = 0.0f;
 }
 
+const Vec<2>& PenetrationConstraint::GetCachedLambda() const
+{
+	return cachedLambda;
+}
+
+// Used to warm start the constraint with the impulses of the same contact in the previous frame
+void PenetrationConstraint::SetCachedLambda(const Vec<2>& lambda)
+{
+	cachedLambda = lambda;
+}
+
 void PenetrationConstraint::PreSolve(const float dt)
 {
-	// Get the collision points position in world space
-	const Vec2 pa = a->LocalSpaceToWorldSpace(aPoint);
-	const Vec2 pb = b->LocalSpaceToWorldSpace(bPoint);
-	Vec2 n = a->LocalSpaceToWorldSpace(normal); // Normal vector to local space
+	const Transform aTransform = a->GetTransform();
+	const Transform bTransform = b->GetTransform();
 
-	const Vec2 ra = pa - a->position;
-	const Vec2 rb = pb - b->position;
+	// Collision points relative to the centers, rotated to world space without
+	// going through world positions (they lose precision far from the origin)
+	const Vec2 ra = aTransform.rotation.Rotate(aPoint);
+	const Vec2 rb = bTransform.rotation.Rotate(bPoint);
+	const Vec2 pa = ra + aTransform.position;
+	const Vec2 pb = rb + bTransform.position;
+	Vec2 n = aTransform.rotation.Rotate(normal); // Normal vector to world space
 
 	jacobian.Zero();
 
@@ -223,10 +262,15 @@ void PenetrationConstraint::PreSolve(const float dt)
         jacobian.rows[1][5] = rb.Cross(t);   // B angular velocity
 	}
 
+	// The Jacobian and the masses don't change until PostSolve(), so the
+	// effective masses are computed only once instead of on every Solve() call
+	lhs = jacobian.MultiplyDiagonalTranspose(GetInvM());
+	normalMass = InverseOrZero(lhs.rows[0][0]);
+	tangentMass = InverseOrZero(lhs.rows[1][1]);
+
 	// Before anything else, apply the cachedLambda from the previous Solve() call
 	// This is the warm-starting technique
-	const MatMN Jt = jacobian.Transpose();
-	VecN impulses = Jt * cachedLambda;
+	const Vec<6> impulses = jacobian.TransposeMultiply(cachedLambda);
 	
 	// Apply the impulses to both A & B
 	a->ApplyImpulseLinear(Vec2(impulses[0], impulses[1])); // A linear impulse
@@ -237,12 +281,13 @@ void PenetrationConstraint::PreSolve(const float dt)
 
 	// Compute the bias term (Baumgarte stabilization technique)
 	const float beta = 0.2f;
+	const float slop = 0.01f * PIXELS_PER_METER; // allowed penetration (1 cm), lets resting contacts settle
 	float C = (pb - pa).Dot(-n); //Compute the positional error
-	C = std::min(0.0f, C + 0.01f);
+	C = std::min(0.0f, C + slop);
 
 	// Calculate relative velocity pre-impulse normal, which will be used to compute elasticity
-	Vec2 va = a->velocity + Vec2(-a->angularVelocity * ra.y, a->angularVelocity * ra.x);
-	Vec2 vb = b->velocity + Vec2(-b->angularVelocity * rb.y, b->angularVelocity * rb.x);
+	Vec2 va = a->GetVelocity() + Vec2(-a->GetAngularVelocity() * ra.y, a->GetAngularVelocity() * ra.x);
+	Vec2 vb = b->GetVelocity() + Vec2(-b->GetAngularVelocity() * rb.y, b->GetAngularVelocity() * rb.x);
 	float vrelDotNormal = (va - vb).Dot(n);
 
 	// Get the restitution between the two bodies
@@ -254,22 +299,23 @@ void PenetrationConstraint::PreSolve(const float dt)
 
 void PenetrationConstraint::Solve()
 {
-	const VecN V = GetVelocities();
-	const MatMN invM = GetInvM();
-
-	const MatMN J = jacobian;
-	const MatMN Jt = jacobian.Transpose();
+	const Vec<6> V = GetVelocities();
 
-	// Compute lambda using Ax = b (Gauss-Seidel method)
+	// Compute lambda using Ax = b (Gauss-Seidel method), with A = J * invM * Jt precomputed in PreSolve()
 	// Lambda being the magnitude of the impulses
-	MatMN lhs = J * invM * Jt; // A (left hand side)
-	VecN rhs = J * V * -1.0f;  // b (right hand side)
+	Vec<2> rhs = jacobian * V * -1.0f; // b (right hand side)
 	rhs[0] -= bias;
 
-	VecN lambda = MatMN::SolveGaussSeidel(lhs, rhs);
+	Vec<2> lambda;
+	lambda.Zero();
+	for (int iteration = 0; iteration < 2; iteration++)
+	{
+		lambda[0] += (rhs[0] - lhs.rows[0].Dot(lambda)) * normalMass;
+		lambda[1] += (rhs[1] - lhs.rows[1].Dot(lambda)) * tangentMass;
+	}
 
 	// Accumulate impulses and clamp it within constraint limits
-	VecN oldLambda = cachedLambda;
+	Vec<2> oldLambda = cachedLambda;
 	cachedLambda += lambda;
 	cachedLambda[0] = (cachedLambda[0] < 0.0f) ? 0.0f : cachedLambda[0];
 
@@ -283,7 +329,7 @@ void PenetrationConstraint::Solve()
 	lambda = cachedLambda - oldLambda;
 
 	// Compute the final impulses with direction and magnitude
-	VecN impulses = Jt * lambda;
+	Vec<6> impulses = jacobian.TransposeMultiply(lambda);
 
 	// Apply the impulses to both A & B
 	a->ApplyImpulseLinear(Vec2(impulses[0], impulses[1])); // A linear impulse
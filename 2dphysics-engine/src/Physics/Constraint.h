@@ -2,7 +2,7 @@
 #define CONSTRAINT_H
 
 #include "./Body.h"
-#include "./MatMN.h"
+#include "./Mat.h"
 
 class Constraint
 {
@@ -15,8 +15,8 @@ public:
 
 	virtual ~Constraint() = default;
 
-	MatMN GetInvM() const;
-	VecN GetVelocities() const;
+	Vec<6> GetInvM() const;
+	Vec<6> GetVelocities() const;
 
 	virtual void PreSolve(const float dt) {}
 	virtual void Solve() {}
@@ -27,13 +27,19 @@ class JointConstraint : public Constraint
 {
 private:
 
-	MatMN jacobian;
-	VecN cachedLambda;
+	Mat<1, 6> jacobian;
+	Vec<1> cachedLambda;
 	float bias;
+	float effectiveMass; // 1 / (J * invM * Jt), computed once in PreSolve()
 
 public:
 	JointConstraint();
 	JointConstraint(Body* a, Body* b, const Vec2& anchorPoint);
+
+	// Allocated from a pool (see Pool.h)
+	static void* operator new(std::size_t size);
+	static void operator delete(void* block, std::size_t size);
+	static const PoolStats& GetPoolStats();
 	void PreSolve(const float dt) override;
 	void Solve() override;
 	void PostSolve() override;
@@ -42,15 +48,27 @@ public:
 class PenetrationConstraint : public Constraint
 {
 private:
-	MatMN jacobian;
-	VecN cachedLambda;
+	// Packs the solver data of many constraints into SIMD lanes
+	friend class WideContactSolver;
+
+	Mat<2, 6> jacobian;
+	Vec<2> cachedLambda;
 	float bias;
+	Mat<2, 2> lhs;     // J * invM * Jt, computed once in PreSolve()
+	float normalMass;  // 1 / lhs[0][0]
+	float tangentMass; // 1 / lhs[1][1]
 	Vec2 normal;	// Normal direction of the penetration in A's local space
 	float friction; // Friction coefficient between the two penetrating bodies
 
 public:
+	int feature;    // Feature ID of the contact that created this constraint
+
 	PenetrationConstraint();
-	PenetrationConstraint(Body* a, Body* b, const Vec2& aCollisionPoint, const Vec2& bCollisionPoint, const Vec2& normal);
+	PenetrationConstraint(Body* a, Body* b, const Vec2& aCollisionPoint, const Vec2& bCollisionPoint, const Vec2& normal, int feature = 0);
+
+	const Vec<2>& GetCachedLambda() const;
+	void SetCachedLambda(const Vec<2>& lambda);
+
 	void PreSolve(const float dt) override;
 	void Solve() override;
 	void PostSolve() override;
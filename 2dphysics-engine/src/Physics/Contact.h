@@ -4,6 +4,9 @@
 #include "Vec2.h"
 #include "Body.h"
 
+// Most contacts that two shapes can have (a polygon edge clipped against another one)
+const int MAX_CONTACTS_PER_PAIR = 2;
+
 struct Contact {
     Body* a;
     Body* b;
@@ -13,6 +16,10 @@ struct Contact {
 
     Vec2 normal;
     float depth;
+
+    // Identifies the edges/vertices that generated this contact, so the same
+    // contact can be recognised in the next frame (see ManifoldCache)
+    int feature = 0;
 };
 
 #endif
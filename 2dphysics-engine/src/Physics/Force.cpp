@@ -5,13 +5,13 @@
 Vec2 Force::GenerateDragForce(const Body& body, float k)
 {
     Vec2 dragForce = Vec2(0, 0);
-    if (body.velocity.MagnitudeSquared() > 0)
+    if (body.GetVelocity().MagnitudeSquared() > 0)
     {
 	    // Calculate drag direction (inverse of velocity unit vector)
-        Vec2 dragDirection = body.velocity.UnitVector() * -1.0;
+        Vec2 dragDirection = body.GetVelocity().UnitVector() * -1.0;
 
         // Calculate the drag magnitude, k * |v|^2
-        float dragMagnitude = k * body.velocity.MagnitudeSquared();
+        float dragMagnitude = k * body.GetVelocity().MagnitudeSquared();
 
         // Generate the final drag force with direction and magnitude
         dragForce = dragDirection * dragMagnitude;
@@ -25,7 +25,7 @@ Vec2 Force::GenerateFrictionForce(const Body& body, float k)
     Vec2 frictionForce = Vec2(0, 0);
 
     // Calculate the friction direction (inverse of velocity unit vector)
-    Vec2 frictionDirection = body.velocity.UnitVector() * -1.0;
+    Vec2 frictionDirection = body.GetVelocity().UnitVector() * -1.0;
 
     // Calculate the friction magnitude (simply a constant)
     float frictionMagnitude = k;
@@ -39,7 +39,7 @@ Vec2 Force::GenerateFrictionForce(const Body& body, float k)
 Vec2 Force::GenerateSpringForce(const Body& body, const Vec2& anchor, float restLength, float k)
 {
     // Calculate the distance between the anchor and the object
-    Vec2 d = body.position - anchor;
+    Vec2 d = body.GetPosition() - anchor;
 
     // Find the spring displacement considering the rest length
     float displacement = d.Magnitude() - restLength;
@@ -57,7 +57,7 @@ Vec2 Force::GenerateSpringForce(const Body& body, const Vec2& anchor, float rest
 Vec2 Force::GenerateSpringForce(const Body& a, const Body& b, float restLength, float k)
 {
     // Calculate the distance between the anchor and the object
-    Vec2 d = a.position - b.position;
+    Vec2 d = a.GetPosition() - b.GetPosition();
 
     // Find the spring displacement considering the rest length
     float displacement = d.Magnitude() - restLength;
@@ -75,7 +75,7 @@ Vec2 Force::GenerateSpringForce(const Body& a, const Body& b, float restLength,
 Vec2 Force::GenerateGravitationalForce(const Body& a, const Body& b, float G, float minDistance, float maxDistance)
 {
     // Calculate the distance between the two objects
-    Vec2 d = (b.position - a.position);
+    Vec2 d = (b.GetPosition() - a.GetPosition());
 
     float distanceSquared = d.MagnitudeSquared();
 
@@ -0,0 +1,100 @@
+#include "FrameArena.h"
+
+#include <new>
+
+FrameArena::FrameArena(std::size_t blockSize)
+{
+	this->blockSize = blockSize;
+}
+
+FrameArena::~FrameArena()
+{
+	for (auto& block : blocks)
+	{
+		::operator delete(block.memory);
+	}
+}
+
+void FrameArena::AddBlock(std::size_t size)
+{
+	Block block;
+	block.memory = static_cast<char*>(::operator new(size));
+	block.size = size;
+	blocks.push_back(block);
+
+	stats.capacity += size;
+	stats.blocks++;
+	stats.heapAllocations++;
+}
+
+void* FrameArena::Allocate(std::size_t size, std::size_t alignment)
+{
+	if (size == 0)
+	{
+		size = 1;
+	}
+
+	while (true)
+	{
+		if (currentBlock < (int)blocks.size())
+		{
+			const Block& block = blocks[currentBlock];
+			std::size_t start = (offset + alignment - 1) / alignment * alignment;
+			if (start + size <= block.size)
+			{
+				offset = start + size;
+				stats.used += size;
+				if (stats.used > stats.peak)
+				{
+					stats.peak = stats.used;
+				}
+				return block.memory + start;
+			}
+
+			// Doesn't fit, the rest of this block is wasted until the next reset
+			if (currentBlock + 1 < (int)blocks.size())
+			{
+				currentBlock++;
+				offset = 0;
+				continue;
+			}
+		}
+
+		std::size_t newBlockSize = blockSize;
+		if (newBlockSize < size + alignment)
+		{
+			newBlockSize = size + alignment;
+		}
+		AddBlock(newBlockSize);
+		currentBlock = blocks.size() - 1;
+		offset = 0;
+	}
+}
+
+void FrameArena::Reset()
+{
+	// Several blocks were needed, replace them with one that fits them all. The
+	// extra half keeps a scene that grows slowly from reallocating every step
+	if (blocks.size() > 1)
+	{
+		std::size_t totalSize = 0;
+		for (auto& block : blocks)
+		{
+			totalSize += block.size;
+			::operator delete(block.memory);
+		}
+		blocks.clear();
+		stats.capacity = 0;
+		stats.blocks = 0;
+		AddBlock(totalSize + totalSize / 2);
+	}
+
+	currentBlock = 0;
+	offset = 0;
+	stats.used = 0;
+}
+
+const FrameArenaStats& FrameArena::GetStats() const
+{
+	return stats;
+}
@@ -0,0 +1,74 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// Counters of a frame arena, to check that the step doesn't touch the heap
+struct FrameArenaStats
+{
+	std::size_t capacity = 0;   // bytes taken from the global allocator
+	std::size_t used = 0;       // bytes handed out since the last Reset()
+	std::size_t peak = 0;       // most bytes ever handed out between two resets
+	int blocks = 0;             // blocks taken from the global allocator
+	long long heapAllocations = 0; // blocks allocated since the arena was created
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FrameArena
+///////////////////////////////////////////////////////////////////////////////
+// Bump pointer allocator for the data that only lives during one step (the
+// contacts and the penetration constraints). Allocating is just moving an
+// offset forward, nothing is freed individually and no destructor is called:
+// Reset() at the start of every step makes all the memory available again.
+//
+// When a step needs more memory than the arena has, a new block is taken from
+// the global allocator. The next Reset() replaces all the blocks by a single
+// one that is big enough for the whole step (with some room to spare), so once
+// the arena has grown to the peak usage, stepping the world doesn't allocate.
+//
+// Not thread safe: only the thread that steps the world allocates from it.
+///////////////////////////////////////////////////////////////////////////////
+class FrameArena
+{
+private:
+	struct Block
+	{
+		char* memory;
+		std::size_t size;
+	};
+
+	std::vector<Block> blocks;
+	int currentBlock = 0;
+	std::size_t offset = 0; // first free byte of the current block
+	std::size_t blockSize;
+	FrameArenaStats stats;
+
+	void AddBlock(std::size_t size);
+
+public:
+	static const std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	FrameArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator = (const FrameArena&) = delete;
+
+	// The memory is valid until the next Reset()
+	void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+	// Uninitialized memory for "count" objects of type T (the caller constructs them)
+	template<typename T>
+	T* AllocateArray(int count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	// Makes all the memory available again
+	void Reset();
+
+	const FrameArenaStats& GetStats() const;
+};
+
+#endif
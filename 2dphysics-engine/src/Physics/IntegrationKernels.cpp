@@ -0,0 +1,306 @@
+#include "IntegrationKernels.h"
+#include "Simd.h"
+
+#include <cstring>
+
+#if IMPACT_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// The Vec2 arrays are read as plain arrays of floats (x, y, x, y...)
+static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 must be two packed floats");
+
+static const int SIMULATED_MASK = BodyStore::BODY_ALIVE | BodyStore::BODY_AWAKE | BodyStore::BODY_STATIC;
+static const int SIMULATED_VALUE = BodyStore::BODY_ALIVE | BodyStore::BODY_AWAKE;
+
+void IntegrateForcesScalar(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt)
+{
+	for (int i = begin; i < end; i++)
+	{
+		if (!store.IsSimulated(i))
+		{
+			continue;
+		}
+
+		// Find the linear acceleration based on the forces that are being applied and the mass
+		// (the weight is mass * gravity, so it adds gravity whatever the mass is)
+		Vec2 acceleration = (store.forces[i] + force) * store.invMasses[i] + gravity;
+
+		// Find the angular acceleration based on the torque that is being applied and the moment of inertia
+		float angularAcceleration = (store.torques[i] + torque) * store.invIs[i];
+
+		// Implicit Euler Integration
+		store.velocities[i] += acceleration * dt;
+		store.angularVelocities[i] += angularAcceleration * dt;
+
+		// Clear all the forces and torque acting on the object before the next physics step
+		store.forces[i] = Vec2(0.0, 0.0);
+		store.torques[i] = 0.0;
+	}
+}
+
+void IntegrateVelocitiesScalar(BodyStore& store, int begin, int end, float dt)
+{
+	for (int i = begin; i < end; i++)
+	{
+		if (!store.IsSimulated(i))
+		{
+			continue;
+		}
+
+		// Integrate the velocity to find the new position
+		store.positions[i] += store.velocities[i] * dt;
+
+		// Integrate the angular velocity to find the new angular rotation angle
+		store.rotations[i] += store.angularVelocities[i] * dt;
+	}
+}
+
+#if IMPACT_SIMD_X86
+
+///////////////////////////////////////////////////////////////////////////////
+// SSE2, 4 bodies per iteration
+///////////////////////////////////////////////////////////////////////////////
+
+// All bits set in the lanes of the simulated bodies among flags[0..3]
+static inline __m128 SimulatedMask4(const uint8_t* flags)
+{
+	int packed;
+	memcpy(&packed, flags, sizeof(packed));
+
+	__m128i zero = _mm_setzero_si128();
+	__m128i lanes = _mm_cvtsi32_si128(packed);
+	lanes = _mm_unpacklo_epi8(lanes, zero);
+	lanes = _mm_unpacklo_epi16(lanes, zero);
+	lanes = _mm_and_si128(lanes, _mm_set1_epi32(SIMULATED_MASK));
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(lanes, _mm_set1_epi32(SIMULATED_VALUE)));
+}
+
+// mask ? a : b, lane by lane
+static inline __m128 Select4(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void IntegrateForcesSSE2(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt)
+{
+	float* velocities = reinterpret_cast<float*>(store.velocities.data());
+	float* forces = reinterpret_cast<float*>(store.forces.data());
+	float* angularVelocities = store.angularVelocities.data();
+	float* torques = store.torques.data();
+	const float* invMasses = store.invMasses.data();
+	const float* invIs = store.invIs.data();
+	const uint8_t* flags = store.flags.data();
+
+	const __m128 g = _mm_setr_ps(gravity.x, gravity.y, gravity.x, gravity.y);
+	const __m128 f = _mm_setr_ps(force.x, force.y, force.x, force.y);
+	const __m128 t = _mm_set1_ps(torque);
+	const __m128 h = _mm_set1_ps(dt);
+
+	int i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		// Every linear register holds two bodies (x, y, x, y), so the per
+		// body values are duplicated to match
+		__m128 mask = SimulatedMask4(flags + i);
+		__m128 mask01 = _mm_unpacklo_ps(mask, mask);
+		__m128 mask23 = _mm_unpackhi_ps(mask, mask);
+		__m128 invMass = _mm_loadu_ps(invMasses + i);
+		__m128 invMass01 = _mm_unpacklo_ps(invMass, invMass);
+		__m128 invMass23 = _mm_unpackhi_ps(invMass, invMass);
+
+		__m128 force01 = _mm_loadu_ps(forces + 2 * i);
+		__m128 force23 = _mm_loadu_ps(forces + 2 * i + 4);
+		__m128 velocity01 = _mm_loadu_ps(velocities + 2 * i);
+		__m128 velocity23 = _mm_loadu_ps(velocities + 2 * i + 4);
+
+		// a = (sumForces + force) * invMass + gravity, v += a * dt
+		__m128 acceleration01 = _mm_add_ps(_mm_mul_ps(_mm_add_ps(force01, f), invMass01), g);
+		__m128 acceleration23 = _mm_add_ps(_mm_mul_ps(_mm_add_ps(force23, f), invMass23), g);
+		velocity01 = Select4(mask01, _mm_add_ps(velocity01, _mm_mul_ps(acceleration01, h)), velocity01);
+		velocity23 = Select4(mask23, _mm_add_ps(velocity23, _mm_mul_ps(acceleration23, h)), velocity23);
+
+		_mm_storeu_ps(velocities + 2 * i, velocity01);
+		_mm_storeu_ps(velocities + 2 * i + 4, velocity23);
+		_mm_storeu_ps(forces + 2 * i, _mm_andnot_ps(mask01, force01));
+		_mm_storeu_ps(forces + 2 * i + 4, _mm_andnot_ps(mask23, force23));
+
+		// alpha = (sumTorque + torque) * invI, w += alpha * dt
+		__m128 sumTorque = _mm_loadu_ps(torques + i);
+		__m128 angularVelocity = _mm_loadu_ps(angularVelocities + i);
+		__m128 angularAcceleration = _mm_mul_ps(_mm_add_ps(sumTorque, t), _mm_loadu_ps(invIs + i));
+		angularVelocity = Select4(mask, _mm_add_ps(angularVelocity, _mm_mul_ps(angularAcceleration, h)), angularVelocity);
+
+		_mm_storeu_ps(angularVelocities + i, angularVelocity);
+		_mm_storeu_ps(torques + i, _mm_andnot_ps(mask, sumTorque));
+	}
+
+	IntegrateForcesScalar(store, i, end, gravity, force, torque, dt);
+}
+
+void IntegrateVelocitiesSSE2(BodyStore& store, int begin, int end, float dt)
+{
+	float* positions = reinterpret_cast<float*>(store.positions.data());
+	const float* velocities = reinterpret_cast<const float*>(store.velocities.data());
+	float* rotations = store.rotations.data();
+	const float* angularVelocities = store.angularVelocities.data();
+	const uint8_t* flags = store.flags.data();
+
+	const __m128 h = _mm_set1_ps(dt);
+
+	int i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128 mask = SimulatedMask4(flags + i);
+		__m128 mask01 = _mm_unpacklo_ps(mask, mask);
+		__m128 mask23 = _mm_unpackhi_ps(mask, mask);
+
+		__m128 position01 = _mm_loadu_ps(positions + 2 * i);
+		__m128 position23 = _mm_loadu_ps(positions + 2 * i + 4);
+		__m128 velocity01 = _mm_loadu_ps(velocities + 2 * i);
+		__m128 velocity23 = _mm_loadu_ps(velocities + 2 * i + 4);
+		position01 = Select4(mask01, _mm_add_ps(position01, _mm_mul_ps(velocity01, h)), position01);
+		position23 = Select4(mask23, _mm_add_ps(position23, _mm_mul_ps(velocity23, h)), position23);
+		_mm_storeu_ps(positions + 2 * i, position01);
+		_mm_storeu_ps(positions + 2 * i + 4, position23);
+
+		__m128 rotation = _mm_loadu_ps(rotations + i);
+		__m128 angularVelocity = _mm_loadu_ps(angularVelocities + i);
+		rotation = Select4(mask, _mm_add_ps(rotation, _mm_mul_ps(angularVelocity, h)), rotation);
+		_mm_storeu_ps(rotations + i, rotation);
+	}
+
+	IntegrateVelocitiesScalar(store, i, end, dt);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2, 8 bodies per iteration
+///////////////////////////////////////////////////////////////////////////////
+
+// All bits set in the lanes of the simulated bodies among flags[0..7]
+IMPACT_TARGET_AVX2 static inline __m256 SimulatedMask8(const uint8_t* flags)
+{
+	__m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(flags)));
+	lanes = _mm256_and_si256(lanes, _mm256_set1_epi32(SIMULATED_MASK));
+	return _mm256_castsi256_ps(_mm256_cmpeq_epi32(lanes, _mm256_set1_epi32(SIMULATED_VALUE)));
+}
+
+IMPACT_TARGET_AVX2 void IntegrateForcesAVX2(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt)
+{
+	float* velocities = reinterpret_cast<float*>(store.velocities.data());
+	float* forces = reinterpret_cast<float*>(store.forces.data());
+	float* angularVelocities = store.angularVelocities.data();
+	float* torques = store.torques.data();
+	const float* invMasses = store.invMasses.data();
+	const float* invIs = store.invIs.data();
+	const uint8_t* flags = store.flags.data();
+
+	const __m256 g = _mm256_setr_ps(gravity.x, gravity.y, gravity.x, gravity.y, gravity.x, gravity.y, gravity.x, gravity.y);
+	const __m256 f = _mm256_setr_ps(force.x, force.y, force.x, force.y, force.x, force.y, force.x, force.y);
+	const __m256 t = _mm256_set1_ps(torque);
+	const __m256 h = _mm256_set1_ps(dt);
+
+	// Duplicate the values of bodies 0-3 and 4-7 to match the (x, y) layout
+	const __m256i lowBodies = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	const __m256i highBodies = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+	int i = begin;
+	for (; i + 8 <= end; i += 8)
+	{
+		__m256 mask = SimulatedMask8(flags + i);
+		__m256 maskLow = _mm256_permutevar8x32_ps(mask, lowBodies);
+		__m256 maskHigh = _mm256_permutevar8x32_ps(mask, highBodies);
+		__m256 invMass = _mm256_loadu_ps(invMasses + i);
+		__m256 invMassLow = _mm256_permutevar8x32_ps(invMass, lowBodies);
+		__m256 invMassHigh = _mm256_permutevar8x32_ps(invMass, highBodies);
+
+		__m256 forceLow = _mm256_loadu_ps(forces + 2 * i);
+		__m256 forceHigh = _mm256_loadu_ps(forces + 2 * i + 8);
+		__m256 velocityLow = _mm256_loadu_ps(velocities + 2 * i);
+		__m256 velocityHigh = _mm256_loadu_ps(velocities + 2 * i + 8);
+
+		// a = (sumForces + force) * invMass + gravity, v += a * dt
+		__m256 accelerationLow = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(forceLow, f), invMassLow), g);
+		__m256 accelerationHigh = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(forceHigh, f), invMassHigh), g);
+		velocityLow = _mm256_blendv_ps(velocityLow, _mm256_add_ps(velocityLow, _mm256_mul_ps(accelerationLow, h)), maskLow);
+		velocityHigh = _mm256_blendv_ps(velocityHigh, _mm256_add_ps(velocityHigh, _mm256_mul_ps(accelerationHigh, h)), maskHigh);
+
+		_mm256_storeu_ps(velocities + 2 * i, velocityLow);
+		_mm256_storeu_ps(velocities + 2 * i + 8, velocityHigh);
+		_mm256_storeu_ps(forces + 2 * i, _mm256_andnot_ps(maskLow, forceLow));
+		_mm256_storeu_ps(forces + 2 * i + 8, _mm256_andnot_ps(maskHigh, forceHigh));
+
+		// alpha = (sumTorque + torque) * invI, w += alpha * dt
+		__m256 sumTorque = _mm256_loadu_ps(torques + i);
+		__m256 angularVelocity = _mm256_loadu_ps(angularVelocities + i);
+		__m256 angularAcceleration = _mm256_mul_ps(_mm256_add_ps(sumTorque, t), _mm256_loadu_ps(invIs + i));
+		angularVelocity = _mm256_blendv_ps(angularVelocity, _mm256_add_ps(angularVelocity, _mm256_mul_ps(angularAcceleration, h)), mask);
+
+		_mm256_storeu_ps(angularVelocities + i, angularVelocity);
+		_mm256_storeu_ps(torques + i, _mm256_andnot_ps(mask, sumTorque));
+	}
+
+	IntegrateForcesScalar(store, i, end, gravity, force, torque, dt);
+}
+
+IMPACT_TARGET_AVX2 void IntegrateVelocitiesAVX2(BodyStore& store, int begin, int end, float dt)
+{
+	float* positions = reinterpret_cast<float*>(store.positions.data());
+	const float* velocities = reinterpret_cast<const float*>(store.velocities.data());
+	float* rotations = store.rotations.data();
+	const float* angularVelocities = store.angularVelocities.data();
+	const uint8_t* flags = store.flags.data();
+
+	const __m256 h = _mm256_set1_ps(dt);
+	const __m256i lowBodies = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	const __m256i highBodies = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+	int i = begin;
+	for (; i + 8 <= end; i += 8)
+	{
+		__m256 mask = SimulatedMask8(flags + i);
+		__m256 maskLow = _mm256_permutevar8x32_ps(mask, lowBodies);
+		__m256 maskHigh = _mm256_permutevar8x32_ps(mask, highBodies);
+
+		__m256 positionLow = _mm256_loadu_ps(positions + 2 * i);
+		__m256 positionHigh = _mm256_loadu_ps(positions + 2 * i + 8);
+		__m256 velocityLow = _mm256_loadu_ps(velocities + 2 * i);
+		__m256 velocityHigh = _mm256_loadu_ps(velocities + 2 * i + 8);
+		positionLow = _mm256_blendv_ps(positionLow, _mm256_add_ps(positionLow, _mm256_mul_ps(velocityLow, h)), maskLow);
+		positionHigh = _mm256_blendv_ps(positionHigh, _mm256_add_ps(positionHigh, _mm256_mul_ps(velocityHigh, h)), maskHigh);
+		_mm256_storeu_ps(positions + 2 * i, positionLow);
+		_mm256_storeu_ps(positions + 2 * i + 8, positionHigh);
+
+		__m256 rotation = _mm256_loadu_ps(rotations + i);
+		__m256 angularVelocity = _mm256_loadu_ps(angularVelocities + i);
+		rotation = _mm256_blendv_ps(rotation, _mm256_add_ps(rotation, _mm256_mul_ps(angularVelocity, h)), mask);
+		_mm256_storeu_ps(rotations + i, rotation);
+	}
+
+	IntegrateVelocitiesScalar(store, i, end, dt);
+}
+
+#else
+
+// No SIMD on this CPU, GetSimdLevel() never selects these
+void IntegrateForcesSSE2(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt)
+{
+	IntegrateForcesScalar(store, begin, end, gravity, force, torque, dt);
+}
+
+void IntegrateForcesAVX2(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt)
+{
+	IntegrateForcesScalar(store, begin, end, gravity, force, torque, dt);
+}
+
+void IntegrateVelocitiesSSE2(BodyStore& store, int begin, int end, float dt)
+{
+	IntegrateVelocitiesScalar(store, begin, end, dt);
+}
+
+void IntegrateVelocitiesAVX2(BodyStore& store, int begin, int end, float dt)
+{
+	IntegrateVelocitiesScalar(store, begin, end, dt);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef INTEGRATIONKERNELS_H
+#define INTEGRATIONKERNELS_H
+
+#include "./BodyStore.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Integration kernels
+///////////////////////////////////////////////////////////////////////////////
+// The loops behind BodyStore::IntegrateForces() and IntegrateVelocities(),
+// one version per instruction set. The SSE2 kernels handle 4 bodies per
+// iteration and the AVX2 ones 8, the remaining bodies go through the scalar
+// kernel. All of them do the same operations in the same order (no fused
+// multiply-add), so they produce exactly the same results.
+//
+// The bodies that aren't simulated (static, sleeping or free slots) are left
+// untouched, the SIMD kernels blend them back from their flags.
+///////////////////////////////////////////////////////////////////////////////
+void IntegrateForcesScalar(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt);
+void IntegrateForcesSSE2(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt);
+void IntegrateForcesAVX2(BodyStore& store, int begin, int end, const Vec2& gravity, const Vec2& force, float torque, float dt);
+
+void IntegrateVelocitiesScalar(BodyStore& store, int begin, int end, float dt);
+void IntegrateVelocitiesSSE2(BodyStore& store, int begin, int end, float dt);
+void IntegrateVelocitiesAVX2(BodyStore& store, int begin, int end, float dt);
+
+#endif
@@ -0,0 +1,255 @@
+#include "Island.h"
+#include "Constants.h"
+
+#include <algorithm>
+
+// Counting sort of the items by island: items[start[i]..start[i + 1]) are the
+// items whose key is i, in increasing order. Items with a key of -1 are dropped.
+static void GroupByIsland(const std::vector<int>& keys, int numIslands, std::vector<int>& start, std::vector<int>& items)
+{
+	start.assign(numIslands + 1, 0);
+	for (int key : keys)
+	{
+		if (key != -1)
+		{
+			start[key + 1]++;
+		}
+	}
+	for (int i = 0; i < numIslands; i++)
+	{
+		start[i + 1] += start[i];
+	}
+
+	// Filling moves every start to the end of its island, which is the start of the next one
+	items.resize(start[numIslands]);
+	for (int i = 0; i < (int)keys.size(); i++)
+	{
+		if (keys[i] != -1)
+		{
+			items[start[keys[i]]++] = i;
+		}
+	}
+	for (int i = numIslands; i > 0; i--)
+	{
+		start[i] = start[i - 1];
+	}
+	start[0] = 0;
+}
+
+void IslandGraph::Reset(int numBodies)
+{
+	parent.resize(numBodies);
+	for (int i = 0; i < numBodies; i++)
+	{
+		parent[i] = i;
+	}
+}
+
+int IslandGraph::Find(int body)
+{
+	// Path halving keeps the trees flat without recursion
+	while (parent[body] != body)
+	{
+		parent[body] = parent[parent[body]];
+		body = parent[body];
+	}
+	return body;
+}
+
+void IslandGraph::Link(const Body* a, const Body* b)
+{
+	if (a->IsStatic() || b->IsStatic())
+	{
+		return;
+	}
+
+	int rootA = Find(a->index);
+	int rootB = Find(b->index);
+	if (rootA == rootB)
+	{
+		return;
+	}
+
+	// The smallest index is always the root so the result doesn't depend on the linking order
+	if (rootA < rootB)
+	{
+		parent[rootB] = rootA;
+	}
+	else
+	{
+		parent[rootA] = rootB;
+	}
+}
+
+void IslandGraph::Build(const std::vector<Body*>& bodies)
+{
+	const int numBodies = bodies.size();
+
+	// Number the islands in the order of their first (smallest) body
+	bodyIsland.assign(numBodies, -1);
+	int numIslands = 0;
+	for (int i = 0; i < numBodies; i++)
+	{
+		if (bodies[i]->IsStatic())
+		{
+			continue;
+		}
+
+		int root = Find(i);
+		if (root == i)
+		{
+			bodyIsland[i] = numIslands++;
+		}
+		else
+		{
+			bodyIsland[i] = bodyIsland[root]; // the root always comes first
+		}
+	}
+
+	GroupByIsland(bodyIsland, numIslands, islandStart, islandBodies);
+	stats.islands = numIslands;
+}
+
+int IslandGraph::GetIsland(const Constraint& constraint) const
+{
+	// Both bodies are in the same island unless one of them is static
+	if (!constraint.a->IsStatic())
+	{
+		return bodyIsland[constraint.a->index];
+	}
+	if (!constraint.b->IsStatic())
+	{
+		return bodyIsland[constraint.b->index];
+	}
+	return -1;
+}
+
+void IslandGraph::BuildConstraints(const std::vector<Constraint*>& joints, const PenetrationConstraint* penetrations, int numPenetrations)
+{
+	keys.clear();
+	for (auto joint : joints)
+	{
+		keys.push_back(GetIsland(*joint));
+	}
+	GroupByIsland(keys, GetNumIslands(), jointStart, islandJoints);
+
+	keys.clear();
+	for (int i = 0; i < numPenetrations; i++)
+	{
+		keys.push_back(GetIsland(penetrations[i]));
+	}
+	GroupByIsland(keys, GetNumIslands(), penetrationStart, islandPenetrations);
+}
+
+bool IslandGraph::WakeIslands(std::vector<Body*>& bodies)
+{
+	bool wokeAny = false;
+	for (int island = 0; island < GetNumIslands(); island++)
+	{
+		bool isAwake = false;
+		for (int i = islandStart[island]; i < islandStart[island + 1]; i++)
+		{
+			if (bodies[islandBodies[i]]->IsAwake())
+			{
+				isAwake = true;
+				break;
+			}
+		}
+
+		if (!isAwake)
+		{
+			continue;
+		}
+
+		// Something touched the island, wake all of it
+		for (int i = islandStart[island]; i < islandStart[island + 1]; i++)
+		{
+			Body* body = bodies[islandBodies[i]];
+			if (!body->IsAwake())
+			{
+				body->SetAwake(true);
+				wokeAny = true;
+			}
+		}
+	}
+	return wokeAny;
+}
+
+void IslandGraph::UpdateSleep(std::vector<Body*>& bodies, float dt, bool allowSleeping)
+{
+	stats.awakeBodies = 0;
+	stats.sleepingBodies = 0;
+
+	for (int island = 0; island < GetNumIslands(); island++)
+	{
+		const int first = islandStart[island];
+		const int last = islandStart[island + 1];
+
+		if (!bodies[islandBodies[first]]->IsAwake())
+		{
+			stats.sleepingBodies += last - first;
+			continue;
+		}
+
+		// The island can only sleep when its most restless body can
+		float minSleepTime = TIME_TO_SLEEP;
+		for (int i = first; i < last; i++)
+		{
+			Body* body = bodies[islandBodies[i]];
+			body->UpdateSleepTime(dt);
+			minSleepTime = std::min(minSleepTime, body->sleepTime);
+		}
+
+		if (allowSleeping && minSleepTime >= TIME_TO_SLEEP)
+		{
+			for (int i = first; i < last; i++)
+			{
+				bodies[islandBodies[i]]->SetAwake(false);
+			}
+			stats.sleepingBodies += last - first;
+		}
+		else
+		{
+			stats.awakeBodies += last - first;
+		}
+	}
+}
+
+int IslandGraph::GetNumIslands() const
+{
+	return islandStart.empty() ? 0 : islandStart.size() - 1;
+}
+
+int IslandGraph::GetIsland(int body) const
+{
+	return bodyIsland[body];
+}
+
+bool IslandGraph::IsIslandAwake(int island, const std::vector<Body*>& bodies) const
+{
+	// All the bodies of an island are either awake or sleeping after WakeIslands()
+	return bodies[islandBodies[islandStart[island]]]->IsAwake();
+}
+
+const int* IslandGraph::GetIslandBodies(int island, int& count) const
+{
+	count = islandStart[island + 1] - islandStart[island];
+	return islandBodies.data() + islandStart[island];
+}
+
+const int* IslandGraph::GetIslandJoints(int island, int& count) const
+{
+	count = jointStart[island + 1] - jointStart[island];
+	return islandJoints.data() + jointStart[island];
+}
+
+const int* IslandGraph::GetIslandPenetrations(int island, int& count) const
+{
+	count = penetrationStart[island + 1] - penetrationStart[island];
+	return islandPenetrations.data() + penetrationStart[island];
+}
+
+const IslandStats& IslandGraph::GetStats() const
+{
+	return stats;
+}
@@ -0,0 +1,79 @@
+#ifndef ISLAND_H
+#define ISLAND_H
+
+#include "./Body.h"
+#include "./Constraint.h"
+
+#include <vector>
+
+// Counters of the last step
+struct IslandStats
+{
+	int islands = 0;        // number of islands (groups of connected dynamic bodies)
+	int awakeBodies = 0;    // dynamic bodies that were simulated
+	int sleepingBodies = 0; // dynamic bodies that were skipped
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// IslandGraph
+///////////////////////////////////////////////////////////////////////////////
+// Groups the dynamic bodies that are connected by joints or contacts into
+// islands (union-find over the body indices). Static bodies never connect
+// two islands, so two piles on the same floor stay independent. Islands
+// sleep and wake as a whole: touching a single body of a sleeping island
+// wakes all of it, and an island only falls asleep once all its bodies have
+// been resting for TIME_TO_SLEEP seconds.
+///////////////////////////////////////////////////////////////////////////////
+class IslandGraph
+{
+private:
+	std::vector<int> parent;       // union-find forest, indexed by body index
+	std::vector<int> bodyIsland;   // island of every body, -1 for static bodies
+	std::vector<int> islandStart;  // first body of every island in islandBodies (plus one past the end)
+	std::vector<int> islandBodies; // body indices grouped by island
+
+	// Same for the joints and the penetration constraints (indices into the world's lists)
+	std::vector<int> jointStart;
+	std::vector<int> islandJoints;
+	std::vector<int> penetrationStart;
+	std::vector<int> islandPenetrations;
+
+	std::vector<int> keys; // scratch buffer used to group the constraints
+	IslandStats stats;
+
+	int Find(int body);
+	int GetIsland(const Constraint& constraint) const;
+
+public:
+	IslandGraph() = default;
+	~IslandGraph() = default;
+
+	// Starts a new graph where every body is alone in its own island
+	void Reset(int numBodies);
+
+	// Connects the islands of two bodies (ignored if any of them is static)
+	void Link(const Body* a, const Body* b);
+
+	// Groups the bodies by island, in the order of their first body
+	void Build(const std::vector<Body*>& bodies);
+
+	// Groups the constraints by island (after Build()), keeping their relative order
+	void BuildConstraints(const std::vector<Constraint*>& joints, const PenetrationConstraint* penetrations, int numPenetrations);
+
+	// Wakes every island that has at least one awake body, returns true if it woke any body
+	bool WakeIslands(std::vector<Body*>& bodies);
+
+	// Updates the sleep timers and, if allowed, puts to sleep the islands that have been resting long enough
+	void UpdateSleep(std::vector<Body*>& bodies, float dt, bool allowSleeping);
+
+	int GetNumIslands() const;
+	int GetIsland(int body) const;
+	bool IsIslandAwake(int island, const std::vector<Body*>& bodies) const;
+	const int* GetIslandBodies(int island, int& count) const;
+	const int* GetIslandJoints(int island, int& count) const;
+	const int* GetIslandPenetrations(int island, int& count) const;
+
+	const IslandStats& GetStats() const;
+};
+
+#endif
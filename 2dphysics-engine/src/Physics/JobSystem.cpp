@@ -0,0 +1,159 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(int numThreads)
+	: numThreads(std::max(1, numThreads)), queues(std::max(1, numThreads))
+{
+	queuedJobs = 0;
+	remainingJobs = 0;
+
+	// The calling thread is thread 0, so only numThreads - 1 workers are needed
+	for (int thread = 1; thread < this->numThreads; thread++)
+	{
+		workers.emplace_back(&JobSystem::WorkerLoop, this, thread);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+		stop = true;
+	}
+	wakeCondition.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+int JobSystem::GetNumThreads() const
+{
+	return numThreads;
+}
+
+bool JobSystem::PopJob(int thread, Job& job)
+{
+	Queue& queue = queues[thread];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.front == (int)queue.jobs.size())
+	{
+		return false;
+	}
+
+	job = queue.jobs.back();
+	queue.jobs.pop_back();
+	queuedJobs--;
+	return true;
+}
+
+bool JobSystem::StealJob(int thread, Job& job)
+{
+	// Start with the next thread so the victims are spread evenly
+	for (int i = 1; i < numThreads; i++)
+	{
+		Queue& queue = queues[(thread + i) % numThreads];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.front < (int)queue.jobs.size())
+		{
+			job = queue.jobs[queue.front++];
+			queuedJobs--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::RunJob(const Job& job, int thread)
+{
+	for (int item = job.begin; item < job.end; item++)
+	{
+		(*task)(item, thread);
+	}
+	remainingJobs--;
+}
+
+void JobSystem::WorkerLoop(int thread)
+{
+	while (true)
+	{
+		Job job;
+		if (PopJob(thread, job) || StealJob(thread, job))
+		{
+			RunJob(job, thread);
+			continue;
+		}
+
+		// Nothing left to do, sleep until the next ParallelFor() call
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		wakeCondition.wait(lock, [this] { return stop || queuedJobs > 0; });
+		if (stop)
+		{
+			return;
+		}
+	}
+}
+
+void JobSystem::ParallelFor(int count, int batchSize, const JobTask& task)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	batchSize = std::max(1, batchSize);
+
+	// Nobody to share the work with
+	if (numThreads == 1 || count <= batchSize)
+	{
+		for (int item = 0; item < count; item++)
+		{
+			task(item, 0);
+		}
+		return;
+	}
+
+	this->task = &task;
+	const int numJobs = (count + batchSize - 1) / batchSize;
+	remainingJobs = numJobs;
+
+	// The jobs of the previous call are all done, start the queues from scratch
+	for (auto& queue : queues)
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.clear();
+		queue.front = 0;
+	}
+
+	// Deal the batches to the queues like cards, so every thread starts with its own share
+	for (int i = 0; i < numJobs; i++)
+	{
+		Queue& queue = queues[i % numThreads];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back({ i * batchSize, std::min(count, (i + 1) * batchSize) });
+		queuedJobs++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(wakeMutex);
+	}
+	wakeCondition.notify_all();
+
+	// Help until every job is done
+	while (remainingJobs > 0)
+	{
+		Job job;
+		if (PopJob(0, job) || StealJob(0, job))
+		{
+			RunJob(job, 0);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	this->task = nullptr;
+}
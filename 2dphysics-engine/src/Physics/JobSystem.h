@@ -0,0 +1,98 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Reference to the task of a ParallelFor() call, called with (item, thread).
+// Unlike a std::function it doesn't copy the lambda (which would allocate
+// memory when it captures more than a couple of pointers), so the lambda must
+// outlive the call, which it always does when it is written in place.
+class JobTask
+{
+private:
+	const void* function;
+	void (*invoke)(const void* function, int item, int thread);
+
+public:
+	template<typename Function>
+	JobTask(const Function& function)
+	{
+		this->function = &function;
+		this->invoke = [](const void* function, int item, int thread)
+		{
+			(*static_cast<const Function*>(function))(item, thread);
+		};
+	}
+
+	void operator () (int item, int thread) const
+	{
+		invoke(function, item, thread);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// JobSystem
+///////////////////////////////////////////////////////////////////////////////
+// A small work-stealing thread pool. ParallelFor() splits a range of items
+// into batches that are spread over one queue per thread; every thread takes
+// jobs from the back of its own queue and, once it runs out, steals from the
+// front of the others. The calling thread works too (it is thread 0), so a
+// job system with a single thread just runs everything inline.
+//
+// The order in which the batches run is not deterministic, so the jobs must
+// only touch data that belongs to their items (e.g. the bodies of an island).
+///////////////////////////////////////////////////////////////////////////////
+class JobSystem
+{
+private:
+	// A batch of items of the current ParallelFor() call
+	struct Job
+	{
+		int begin;
+		int end;
+	};
+
+	// All the jobs are queued before any of them runs, so a vector is enough:
+	// the owner takes them from the back and the thieves from "front". It keeps
+	// its memory between calls, so ParallelFor() doesn't allocate
+	struct Queue
+	{
+		std::mutex mutex;
+		std::vector<Job> jobs;
+		int front = 0;
+	};
+
+	int numThreads;
+	std::vector<std::thread> workers;
+	std::vector<Queue> queues; // one per thread, queue 0 belongs to the calling thread
+
+	// Task of the current ParallelFor() call, called with (item, thread)
+	const JobTask* task = nullptr;
+	std::atomic<int> queuedJobs;    // jobs waiting in the queues
+	std::atomic<int> remainingJobs; // jobs not finished yet
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	bool stop = false;
+
+	bool PopJob(int thread, Job& job);
+	bool StealJob(int thread, Job& job);
+	void RunJob(const Job& job, int thread);
+	void WorkerLoop(int thread);
+
+public:
+	JobSystem(int numThreads);
+	~JobSystem();
+
+	int GetNumThreads() const;
+
+	// Calls task(item, thread) for every item in [0, count), in batches of
+	// batchSize items, and returns once all of them are done. Not reentrant.
+	void ParallelFor(int count, int batchSize, const JobTask& task);
+};
+
+#endif
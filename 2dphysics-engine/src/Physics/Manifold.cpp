@@ -0,0 +1,189 @@
+#include "Manifold.h"
+
+#include <cstdint>
+
+int ManifoldCache::GetHome(const BodyPair& pair) const
+{
+	// The addresses of the bodies are aligned, so their low bits must be mixed with the high ones
+	std::uint64_t h1 = (std::uint64_t)(std::uintptr_t)pair.first * 0x9e3779b97f4a7c15ULL;
+	std::uint64_t h2 = (std::uint64_t)(std::uintptr_t)pair.second * 0xc2b2ae3d27d4eb4fULL;
+	std::uint64_t hash = h1 ^ (h2 + (h1 >> 29));
+	hash ^= hash >> 32;
+	return (int)(hash & (entries.size() - 1));
+}
+
+int ManifoldCache::Find(const BodyPair& pair) const
+{
+	if (size == 0)
+	{
+		return -1;
+	}
+
+	const int mask = entries.size() - 1;
+	for (int slot = GetHome(pair);; slot = (slot + 1) & mask)
+	{
+		if (entries[slot].pair == pair)
+		{
+			return slot;
+		}
+		if (!entries[slot].pair.first)
+		{
+			return -1;
+		}
+	}
+}
+
+int ManifoldCache::FindOrInsert(const BodyPair& pair)
+{
+	// Keep at least half of the slots empty, so the probes stay short
+	if ((size + 1) * 2 > (int)entries.size())
+	{
+		Grow();
+	}
+
+	const int mask = entries.size() - 1;
+	for (int slot = GetHome(pair);; slot = (slot + 1) & mask)
+	{
+		if (entries[slot].pair == pair)
+		{
+			return slot;
+		}
+		if (!entries[slot].pair.first)
+		{
+			entries[slot].pair = pair;
+			entries[slot].manifold = Manifold();
+			size++;
+			return slot;
+		}
+	}
+}
+
+void ManifoldCache::Erase(int slot)
+{
+	const int mask = entries.size() - 1;
+	int hole = slot;
+	for (int next = (slot + 1) & mask; entries[next].pair.first; next = (next + 1) & mask)
+	{
+		// An entry can fill the hole if its home slot is not between the hole and itself
+		int home = GetHome(entries[next].pair);
+		bool homeAfterHole = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+		if (!homeAfterHole)
+		{
+			entries[hole] = entries[next];
+			hole = next;
+		}
+	}
+	entries[hole].pair = BodyPair(nullptr, nullptr);
+	size--;
+}
+
+void ManifoldCache::Grow()
+{
+	std::vector<Entry> oldEntries;
+	oldEntries.swap(entries);
+	entries.resize(oldEntries.empty() ? MIN_CAPACITY : oldEntries.size() * 2, Entry{ BodyPair(nullptr, nullptr), Manifold() });
+
+	size = 0;
+	for (auto& entry : oldEntries)
+	{
+		if (entry.pair.first)
+		{
+			entries[FindOrInsert(entry.pair)].manifold = entry.manifold;
+		}
+	}
+}
+
+void ManifoldCache::WarmStart(PenetrationConstraint* constraints, int count) const
+{
+	int slot = Find(BodyPair(constraints[0].a, constraints[0].b));
+	if (slot < 0)
+	{
+		return; // The bodies just started touching
+	}
+
+	const Manifold& manifold = entries[slot].manifold;
+	for (int i = 0; i < count; i++)
+	{
+		for (int j = 0; j < manifold.numPoints; j++)
+		{
+			if (manifold.points[j].feature == constraints[i].feature)
+			{
+				constraints[i].SetCachedLambda(manifold.points[j].lambda);
+				break;
+			}
+		}
+	}
+}
+
+void ManifoldCache::Store(const PenetrationConstraint* constraints, int count)
+{
+	Manifold& manifold = entries[FindOrInsert(BodyPair(constraints[0].a, constraints[0].b))].manifold;
+
+	manifold.numPoints = 0;
+	for (int i = 0; i < count && manifold.numPoints < MAX_MANIFOLD_POINTS; i++)
+	{
+		manifold.points[manifold.numPoints].feature = constraints[i].feature;
+		manifold.points[manifold.numPoints].lambda = constraints[i].GetCachedLambda();
+		manifold.numPoints++;
+	}
+	manifold.step = step;
+}
+
+void ManifoldCache::RemoveStale()
+{
+	// Erasing moves a later entry into the slot, so it is checked again before moving on
+	for (int slot = 0; slot < (int)entries.size();)
+	{
+		const Body* a = entries[slot].pair.first;
+		const Body* b = entries[slot].pair.second;
+		if (!a)
+		{
+			slot++;
+			continue;
+		}
+
+		const bool isSleeping = (a->IsStatic() || !a->IsAwake()) && (b->IsStatic() || !b->IsAwake());
+		if (entries[slot].manifold.step != step && !isSleeping)
+		{
+			Erase(slot);
+		}
+		else
+		{
+			slot++;
+		}
+	}
+	step++;
+}
+
+void ManifoldCache::RemoveBody(const Body* body, std::vector<const Body*>& touching)
+{
+	for (int slot = 0; slot < (int)entries.size();)
+	{
+		const BodyPair& pair = entries[slot].pair;
+		if (pair.first && (pair.first == body || pair.second == body))
+		{
+			touching.push_back(pair.first == body ? pair.second : pair.first);
+			Erase(slot);
+		}
+		else
+		{
+			slot++;
+		}
+	}
+}
+
+void ManifoldCache::LinkIslands(IslandGraph& islands) const
+{
+	for (auto& entry : entries)
+	{
+		if (entry.pair.first)
+		{
+			islands.Link(entry.pair.first, entry.pair.second);
+		}
+	}
+}
+
+int ManifoldCache::GetSize() const
+{
+	return size;
+}
@@ -0,0 +1,93 @@
+#ifndef MANIFOLD_H
+#define MANIFOLD_H
+
+#include "./Body.h"
+#include "./Constraint.h"
+#include "./Island.h"
+
+#include <utility>
+#include <vector>
+
+const int MAX_MANIFOLD_POINTS = 2;
+
+// Accumulated impulses of one contact point
+struct ManifoldPoint
+{
+	int feature;
+	Vec<2> lambda; // normal and tangent (friction) impulses
+};
+
+// All the contact points between a pair of bodies in the last frame
+struct Manifold
+{
+	ManifoldPoint points[MAX_MANIFOLD_POINTS];
+	int numPoints = 0;
+	int step = 0;  // last step this manifold was touching
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ManifoldCache
+///////////////////////////////////////////////////////////////////////////////
+// Penetration constraints are created again every frame, so on their own
+// they always start with zero impulses. The cache keeps the accumulated
+// impulses of every contact point, keyed by body pair and feature ID, and
+// copies them into the new constraints of the next frame (warm starting).
+//
+// The manifolds are stored in an open addressing hash table (linear probing)
+// instead of a std::unordered_map, so bodies that start and stop touching
+// don't allocate and free a node every time: the table only allocates when
+// it has to grow.
+///////////////////////////////////////////////////////////////////////////////
+class ManifoldCache
+{
+private:
+	typedef std::pair<const Body*, const Body*> BodyPair;
+
+	// A slot of the table, empty when the first body is nullptr
+	struct Entry
+	{
+		BodyPair pair;
+		Manifold manifold;
+	};
+
+	std::vector<Entry> entries; // the size is always a power of two
+	int size = 0;
+	int step = 0;
+
+	static const int MIN_CAPACITY = 64;
+
+	int GetHome(const BodyPair& pair) const;
+
+	// Slot of the pair, or -1 if it is not in the table
+	int Find(const BodyPair& pair) const;
+
+	// Slot of the pair, inserted with an empty manifold if it was not in the table
+	int FindOrInsert(const BodyPair& pair);
+
+	// Empties a slot and moves back the entries after it, so no lookup stops too early
+	void Erase(int slot);
+	void Grow();
+
+public:
+	// Copies the cached impulses into constraints created for a single pair of bodies
+	void WarmStart(PenetrationConstraint* constraints, int count) const;
+
+	// Saves the impulses of the constraints (all of them between a single pair of bodies)
+	void Store(const PenetrationConstraint* constraints, int count);
+
+	// Forgets the pairs that were not stored during this step and starts a new one.
+	// Pairs of sleeping bodies are kept so they still connect their islands and
+	// warm start the solver when the bodies wake up
+	void RemoveStale();
+
+	// Forgets every pair of a body that is being removed (its address may be
+	// reused by a new body) and appends the bodies it was touching to "touching"
+	void RemoveBody(const Body* body, std::vector<const Body*>& touching);
+
+	// Connects the islands of every pair of bodies in the cache
+	void LinkIslands(IslandGraph& islands) const;
+
+	int GetSize() const;
+};
+
+#endif
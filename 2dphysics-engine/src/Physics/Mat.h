@@ -0,0 +1,104 @@
+#ifndef MAT_H
+#define MAT_H
+
+#include "./Vec.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Fixed size matrix with M rows and N columns
+///////////////////////////////////////////////////////////////////////////////
+// Stack allocated counterpart of MatMN. The dimensions are template
+// parameters, so mismatched products don't compile instead of silently
+// returning the wrong operand.
+///////////////////////////////////////////////////////////////////////////////
+template <int M, int N>
+struct Mat
+{
+	Vec<N> rows[M]; // the rows of the matrix with N columns inside
+
+	void Zero()                                     // m1.Zero()
+	{
+		for (int i = 0; i < M; i++)
+		{
+			rows[i].Zero();
+		}
+	}
+
+	Mat<N, M> Transpose() const                     // m1.Transpose()
+	{
+		Mat<N, M> result;
+		for (int i = 0; i < M; i++)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				result.rows[j][i] = rows[i][j];
+			}
+		}
+		return result;
+	}
+
+	Vec<M> operator * (const Vec<N>& v) const       // m1 * v
+	{
+		Vec<M> result;
+		for (int i = 0; i < M; i++)
+		{
+			result[i] = rows[i].Dot(v);
+		}
+		return result;
+	}
+
+	template <int P>
+	Mat<M, P> operator * (const Mat<N, P>& m) const // m1 * m2
+	{
+		Mat<M, P> result;
+		for (int i = 0; i < M; i++)
+		{
+			for (int j = 0; j < P; j++)
+			{
+				float sum = 0.0f;
+				for (int k = 0; k < N; k++)
+				{
+					sum += rows[i][k] * m.rows[k][j];
+				}
+				result.rows[i][j] = sum;
+			}
+		}
+		return result;
+	}
+
+	// Computes m1 * D * m1^T where D is a diagonal matrix given by its diagonal.
+	// Skips all the multiplications by the zeros outside the diagonal.
+	Mat<M, M> MultiplyDiagonalTranspose(const Vec<N>& diagonal) const
+	{
+		Mat<M, M> result;
+		for (int i = 0; i < M; i++)
+		{
+			for (int j = 0; j < M; j++)
+			{
+				float sum = 0.0f;
+				for (int k = 0; k < N; k++)
+				{
+					sum += rows[i][k] * diagonal[k] * rows[j][k];
+				}
+				result.rows[i][j] = sum;
+			}
+		}
+		return result;
+	}
+
+	// Computes m1^T * v without building the transposed matrix
+	Vec<N> TransposeMultiply(const Vec<M>& v) const
+	{
+		Vec<N> result;
+		result.Zero();
+		for (int i = 0; i < M; i++)
+		{
+			for (int j = 0; j < N; j++)
+			{
+				result[j] += rows[i][j] * v[i];
+			}
+		}
+		return result;
+	}
+};
+
+#endif
@@ -0,0 +1,39 @@
+#include "Narrowphase.h"
+#include "CollisionDetection.h"
+
+void Narrowphase::FindContacts(const std::vector<Body*>& bodies, const std::vector<BroadphasePair>& pairs, JobSystem& jobSystem, FrameArena& arena)
+{
+	contacts = arena.AllocateArray<Contact>(pairs.size() * MAX_CONTACTS_PER_PAIR);
+	pairCounts = arena.AllocateArray<int>(pairs.size());
+
+	jobSystem.ParallelFor(pairs.size(), BATCH_SIZE, [this, &bodies, &pairs](int pair, int thread)
+	{
+		Body* a = bodies[pairs[pair].a];
+		Body* b = bodies[pairs[pair].b];
+		pairCounts[pair] = 0;
+
+		// Sleeping bodies can only be woken up by a body that is awake
+		const bool aIsSimulated = !a->IsStatic() && a->IsAwake();
+		const bool bIsSimulated = !b->IsStatic() && b->IsAwake();
+		if (aIsSimulated || bIsSimulated)
+		{
+			CollisionDetection::IsColliding(a, b, contacts + pair * MAX_CONTACTS_PER_PAIR, pairCounts[pair]);
+		}
+	});
+
+	// Pack the contacts in the order of the pairs (they only ever move to the left)
+	numContacts = 0;
+	for (int pair = 0; pair < (int)pairs.size(); pair++)
+	{
+		for (int i = 0; i < pairCounts[pair]; i++)
+		{
+			contacts[numContacts++] = contacts[pair * MAX_CONTACTS_PER_PAIR + i];
+		}
+	}
+}
+
+const Contact* Narrowphase::GetContacts(int& count) const
+{
+	count = numContacts;
+	return contacts;
+}
@@ -0,0 +1,45 @@
+#ifndef NARROWPHASE_H
+#define NARROWPHASE_H
+
+#include "./Body.h"
+#include "./Contact.h"
+#include "./Broadphase.h"
+#include "./JobSystem.h"
+#include "./FrameArena.h"
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Narrowphase
+///////////////////////////////////////////////////////////////////////////////
+// Runs CollisionDetection::IsColliding() on the broadphase pairs. The pairs
+// are split in batches that the job system spreads over the threads. Every
+// pair has room for MAX_CONTACTS_PER_PAIR contacts in an array taken from the
+// frame arena, so the threads never share anything while the pairs are
+// checked; the contacts are then packed in the order of the pairs, so they
+// are the same no matter how many threads found them.
+///////////////////////////////////////////////////////////////////////////////
+class Narrowphase
+{
+private:
+	// Both point into the frame arena of the last FindContacts() call
+	Contact* contacts = nullptr;
+	int* pairCounts = nullptr;
+	int numContacts = 0;
+
+public:
+	// Number of pairs in every job
+	static const int BATCH_SIZE = 64;
+
+	Narrowphase() = default;
+	~Narrowphase() = default;
+
+	// Finds the contacts of all the pairs where at least one body is awake and
+	// not static. The contacts are allocated from "arena" and stay valid until it is reset
+	void FindContacts(const std::vector<Body*>& bodies, const std::vector<BroadphasePair>& pairs, JobSystem& jobSystem, FrameArena& arena);
+
+	// Contacts of the last FindContacts() call, grouped by pair in the order of the pairs
+	const Contact* GetContacts(int& count) const;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "Pool.h"
+
+#include <new>
+
+Pool::Pool(std::size_t blockSize, int blocksPerChunk)
+{
+	// Every block must be able to hold the free list link and stay aligned
+	const std::size_t alignment = alignof(std::max_align_t);
+	if (blockSize < sizeof(FreeBlock))
+	{
+		blockSize = sizeof(FreeBlock);
+	}
+	this->blockSize = (blockSize + alignment - 1) / alignment * alignment;
+	this->blocksPerChunk = blocksPerChunk;
+	stats.blockSize = this->blockSize;
+}
+
+Pool::~Pool()
+{
+	for (auto chunk : chunks)
+	{
+		::operator delete(chunk);
+	}
+}
+
+void Pool::Grow()
+{
+	char* chunk = static_cast<char*>(::operator new(blockSize * blocksPerChunk));
+	chunks.push_back(chunk);
+	stats.chunks++;
+
+	// Link the new blocks in order, so they are handed out in increasing addresses
+	for (int i = blocksPerChunk - 1; i >= 0; i--)
+	{
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+		block->next = freeList;
+		freeList = block;
+	}
+}
+
+std::size_t Pool::GetBlockSize() const
+{
+	return blockSize;
+}
+
+void* Pool::Allocate()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!freeList)
+	{
+		Grow();
+	}
+
+	FreeBlock* block = freeList;
+	freeList = block->next;
+	stats.liveBlocks++;
+	stats.allocations++;
+	return block;
+}
+
+void Pool::Free(void* block)
+{
+	if (!block)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = freeList;
+	freeList = freeBlock;
+	stats.liveBlocks--;
+	stats.frees++;
+}
+
+const PoolStats& Pool::GetStats() const
+{
+	return stats;
+}
+
+void* AllocateFromPool(Pool& pool, std::size_t size)
+{
+	if (size > pool.GetBlockSize())
+	{
+		return ::operator new(size);
+	}
+	return pool.Allocate();
+}
+
+void FreeToPool(Pool& pool, void* block, std::size_t size)
+{
+	if (size > pool.GetBlockSize())
+	{
+		::operator delete(block);
+		return;
+	}
+	pool.Free(block);
+}
@@ -0,0 +1,69 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Counters of a pool, to check that objects are recycled instead of allocated
+struct PoolStats
+{
+	int blockSize = 0;
+	int chunks = 0;            // chunks taken from the global allocator
+	int liveBlocks = 0;        // blocks handed out and not freed yet
+	long long allocations = 0; // Allocate() calls
+	long long frees = 0;       // Free() calls
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Pool
+///////////////////////////////////////////////////////////////////////////////
+// Fixed size block allocator. Memory is taken from the global allocator in
+// chunks of many blocks and freed blocks go to a free list (stored inside
+// the blocks themselves), so once a pool has grown to the peak number of
+// objects, creating and deleting them never calls the global allocator.
+// The memory is only given back when the pool is destroyed.
+//
+// Body, the shapes and JointConstraint have class specific operator new and
+// operator delete that use a pool each, so "new Body(...)" and "delete body"
+// work the same as before.
+///////////////////////////////////////////////////////////////////////////////
+class Pool
+{
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	std::size_t blockSize;
+	int blocksPerChunk;
+	std::vector<void*> chunks;
+	FreeBlock* freeList = nullptr;
+	PoolStats stats;
+	std::mutex mutex;
+
+	void Grow();
+
+public:
+	static const int DEFAULT_BLOCKS_PER_CHUNK = 256;
+
+	Pool(std::size_t blockSize, int blocksPerChunk = DEFAULT_BLOCKS_PER_CHUNK);
+	~Pool();
+
+	Pool(const Pool&) = delete;
+	Pool& operator = (const Pool&) = delete;
+
+	std::size_t GetBlockSize() const;
+	void* Allocate();
+	void Free(void* block);
+
+	const PoolStats& GetStats() const;
+};
+
+// Helpers for the class specific operator new/delete. Objects of another size
+// (a class derived from a pooled one) go to the global allocator instead.
+void* AllocateFromPool(Pool& pool, std::size_t size);
+void FreeToPool(Pool& pool, void* block, std::size_t size);
+
+#endif
@@ -0,0 +1,124 @@
+#include "Profiler.h"
+
+#include <cstdio>
+
+const char* StepPhaseName(StepPhase phase)
+{
+	switch (phase)
+	{
+	case PHASE_BROADPHASE:
+		return "broadphase";
+	case PHASE_NARROWPHASE:
+		return "narrowphase";
+	case PHASE_CONTACTS:
+		return "contacts";
+	case PHASE_ISLANDS:
+		return "islands";
+	case PHASE_INTEGRATE_FORCES:
+		return "integrate forces";
+	case PHASE_PRESOLVE:
+		return "presolve";
+	case PHASE_SOLVE:
+		return "solve";
+	case PHASE_POSTSOLVE:
+		return "postsolve";
+	case PHASE_INTEGRATE_VELOCITIES:
+		return "integrate velocities";
+	default:
+		return "step";
+	}
+}
+
+StepProfiler::ScopedTimer::ScopedTimer(StepProfiler& profiler, StepPhase phase) : profiler(profiler), phase(phase)
+{
+	start = Clock::now();
+}
+
+StepProfiler::ScopedTimer::~ScopedTimer()
+{
+	Clock::time_point end = Clock::now();
+
+	// Several scopes can add to the same phase in a step
+	std::chrono::duration<double, std::milli> elapsed = end - start;
+	profiler.stats.phaseMs[phase] += elapsed.count();
+
+	if (profiler.tracing)
+	{
+		profiler.AddTraceEvent(phase, start, end);
+	}
+}
+
+void StepProfiler::AddTraceEvent(int phase, Clock::time_point start, Clock::time_point end)
+{
+	std::chrono::duration<double, std::micro> startUs = start - traceStart;
+	std::chrono::duration<double, std::micro> durationUs = end - start;
+	trace.push_back({ phase, startUs.count(), durationUs.count() });
+}
+
+void StepProfiler::BeginStep()
+{
+	stats = StepStats();
+#if IMPACT_PROFILING
+	stepStart = Clock::now();
+#endif
+}
+
+void StepProfiler::EndStep()
+{
+#if IMPACT_PROFILING
+	Clock::time_point end = Clock::now();
+	std::chrono::duration<double, std::milli> elapsed = end - stepStart;
+	stats.totalMs = elapsed.count();
+
+	if (tracing)
+	{
+		AddTraceEvent(NUM_STEP_PHASES, stepStart, end);
+	}
+#endif
+}
+
+StepStats& StepProfiler::GetStats()
+{
+	return stats;
+}
+
+const StepStats& StepProfiler::GetStats() const
+{
+	return stats;
+}
+
+void StepProfiler::SetTracing(bool enabled)
+{
+	if (enabled && !tracing)
+	{
+		trace.clear();
+		traceStart = Clock::now();
+	}
+	tracing = enabled;
+}
+
+bool StepProfiler::IsTracing() const
+{
+	return tracing;
+}
+
+bool StepProfiler::WriteTrace(const char* fileName) const
+{
+	FILE* file = fopen(fileName, "w");
+	if (!file)
+	{
+		return false;
+	}
+
+	// "Complete" events (a start and a duration), all on the same thread
+	fprintf(file, "{\"traceEvents\": [\n");
+	for (int i = 0; i < (int)trace.size(); i++)
+	{
+		const TraceEvent& event = trace[i];
+		fprintf(file, "{\"name\": \"%s\", \"cat\": \"physics\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1}%s\n",
+			StepPhaseName((StepPhase)event.phase), event.startUs, event.durationUs, i + 1 < (int)trace.size() ? "," : "");
+	}
+	fprintf(file, "],\n\"displayTimeUnit\": \"ms\"}\n");
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,105 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <vector>
+
+// The phase timers cost two clock reads per phase and step. Build with
+// -DIMPACT_PROFILING=0 to compile them out (the counters are always kept)
+#ifndef IMPACT_PROFILING
+#define IMPACT_PROFILING 1
+#endif
+
+// Phases of World::Update(), in the order they run
+enum StepPhase
+{
+	PHASE_BROADPHASE,          // finding the pairs and moving the proxies
+	PHASE_NARROWPHASE,         // collision tests of the pairs
+	PHASE_CONTACTS,            // penetration constraints, warm starting and storing the impulses
+	PHASE_ISLANDS,             // building the islands, waking and putting them to sleep
+	PHASE_INTEGRATE_FORCES,    // forces and gravity into the velocities
+	PHASE_PRESOLVE,            // PreSolve() of the constraints of the awake islands
+	PHASE_SOLVE,               // the solver iterations
+	PHASE_POSTSOLVE,           // PostSolve() of the constraints
+	PHASE_INTEGRATE_VELOCITIES, // velocities into the positions and rotations
+	NUM_STEP_PHASES
+};
+
+const char* StepPhaseName(StepPhase phase);
+
+// Timings and counters of the last step
+struct StepStats
+{
+	double phaseMs[NUM_STEP_PHASES] = {}; // wall time of every phase
+	double totalMs = 0.0;                 // the whole step
+	int pairs = 0;                        // broadphase pairs tested by the narrowphase
+	int contacts = 0;                     // contacts (penetration constraints) found
+	int constraints = 0;                  // joints and penetrations of the awake islands
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// StepProfiler
+///////////////////////////////////////////////////////////////////////////////
+// Collects the StepStats of every step of a world, and optionally a trace of
+// the phases in the Chrome trace event format (chrome://tracing, Perfetto).
+// The phases are timed on the thread that steps the world, so with several
+// threads they are wall times, not the sum of the time of every thread.
+///////////////////////////////////////////////////////////////////////////////
+class StepProfiler
+{
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct TraceEvent
+	{
+		int phase; // NUM_STEP_PHASES for the whole step
+		double startUs;
+		double durationUs;
+	};
+
+	StepStats stats;
+	Clock::time_point stepStart;
+
+	bool tracing = false;
+	Clock::time_point traceStart;
+	std::vector<TraceEvent> trace;
+
+	void AddTraceEvent(int phase, Clock::time_point start, Clock::time_point end);
+
+public:
+	// Adds the time of a phase from its construction to its destruction
+	class ScopedTimer
+	{
+	private:
+		StepProfiler& profiler;
+		StepPhase phase;
+		Clock::time_point start;
+
+	public:
+		ScopedTimer(StepProfiler& profiler, StepPhase phase);
+		~ScopedTimer();
+	};
+
+	// Resets the stats of the previous step
+	void BeginStep();
+	void EndStep();
+
+	StepStats& GetStats();
+	const StepStats& GetStats() const;
+
+	// Every step recorded while tracing adds one event per phase. Starting
+	// again clears the events recorded so far
+	void SetTracing(bool enabled);
+	bool IsTracing() const;
+	bool WriteTrace(const char* fileName) const;
+};
+
+#if IMPACT_PROFILING
+#define IMPACT_PROFILE_CONCAT_(a, b) a##b
+#define IMPACT_PROFILE_CONCAT(a, b) IMPACT_PROFILE_CONCAT_(a, b)
+#define IMPACT_PROFILE_SCOPE(profiler, phase) StepProfiler::ScopedTimer IMPACT_PROFILE_CONCAT(scopedTimer, __LINE__)(profiler, phase)
+#else
+#define IMPACT_PROFILE_SCOPE(profiler, phase)
+#endif
+
+#endif
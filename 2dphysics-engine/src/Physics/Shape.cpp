@@ -1,7 +1,31 @@
 #include "Shape.h"
 
 #include <iostream>
+#include <algorithm>
 #include <limits>
+#include <cmath>
+
+// Never destroyed, objects may still be deleted by static destructors at exit
+static Pool& CircleShapePool()
+{
+	static Pool* pool = new Pool(sizeof(CircleShape));
+	return *pool;
+}
+
+void* CircleShape::operator new(std::size_t size)
+{
+	return AllocateFromPool(CircleShapePool(), size);
+}
+
+void CircleShape::operator delete(void* block, std::size_t size)
+{
+	FreeToPool(CircleShapePool(), block, size);
+}
+
+const PoolStats& CircleShape::GetPoolStats()
+{
+	return CircleShapePool().GetStats();
+}
 
 CircleShape::CircleShape(const float radius)
 {
@@ -24,7 +48,7 @@ Shape* CircleShape::Clone() const
 	return new CircleShape(radius);
 }
 
-void CircleShape::UpdateVertices(float angle, const Vec2& position)
+void CircleShape::UpdateVertices(const Transform& transform)
 {
 	return; // Circles don't have vertices, so nothing to update
 }
@@ -36,8 +60,40 @@ float CircleShape::GetMomentOfInertia() const
 	return 0.5 * (radius * radius);
 }
 
+AABB CircleShape::GetAABB(const Transform& transform) const
+{
+	// Rotation doesn't change the bounds of a circle
+	const Vec2& position = transform.position;
+	return AABB(Vec2(position.x - radius, position.y - radius), Vec2(position.x + radius, position.y + radius));
+}
+
+
+static Pool& PolygonShapePool()
+{
+	static Pool* pool = new Pool(sizeof(PolygonShape));
+	return *pool;
+}
+
+void* PolygonShape::operator new(std::size_t size)
+{
+	return AllocateFromPool(PolygonShapePool(), size);
+}
+
+void PolygonShape::operator delete(void* block, std::size_t size)
+{
+	FreeToPool(PolygonShapePool(), block, size);
+}
+
+const PoolStats& PolygonShape::GetPoolStats()
+{
+	return PolygonShapePool().GetStats();
+}
+
+PolygonShape::PolygonShape(const std::vector<Vec2>& vertices) : PolygonShape(vertices.data(), vertices.size())
+{
+}
 
-PolygonShape::PolygonShape(const std::vector<Vec2> vertices)
+PolygonShape::PolygonShape(const Vec2* vertices, int numVertices)
 {
 	float minX = std::numeric_limits<float>::max();
 	float minY = std::numeric_limits<float>::max();
@@ -45,16 +101,14 @@ PolygonShape::PolygonShape(const std::vector<Vec2> vertices)
 	float maxY = std::numeric_limits<float>::lowest();
 
 	// Initialize the vertices of the polygon shape and set width and height
-	for (auto vertex : vertices) 
+	SetVertices(vertices, numVertices);
+	for (int i = 0; i < numVertices; i++) 
 	{
-		localVertices.push_back(vertex);
-		worldVertices.push_back(vertex);
-
 		// Find min and max X and Y to calculate polygon width and height
-		minX = std::min(minX, vertex.x);
-		maxX = std::max(maxX, vertex.x);
-		minY = std::min(minY, vertex.y);
-		maxY = std::max(maxY, vertex.y);
+		minX = std::min(minX, vertices[i].x);
+		maxX = std::max(maxX, vertices[i].x);
+		minY = std::min(minY, vertices[i].y);
+		maxY = std::max(maxY, vertices[i].y);
 	}
 	width = maxX - minX;
 	height = maxY - minY;
@@ -62,11 +116,55 @@ PolygonShape::PolygonShape(const std::vector<Vec2> vertices)
 	std::cout << "PolygonShape constructor called!" << std::endl;
 }
 
+PolygonShape::PolygonShape(const PolygonShape& other) : Shape(other)
+{
+	width = other.width;
+	height = other.height;
+	SetVertices(other.localVertices, other.numVertices);
+
+	// Keep the world state of the other shape
+	for (int i = 0; i < numVertices; i++)
+	{
+		worldVertices[i] = other.worldVertices[i];
+	}
+}
+
 PolygonShape::~PolygonShape()
 {
+	delete[] heapStorage;
 	std::cout << "PolygonShape destructor called!" << std::endl;
 }
 
+void PolygonShape::SetVertices(const Vec2* vertices, int numVertices)
+{
+	delete[] heapStorage;
+	heapStorage = nullptr;
+
+	Vec2* storage = inlineStorage;
+	if (numVertices > MAX_INLINE_VERTICES)
+	{
+		heapStorage = new Vec2[3 * numVertices];
+		storage = heapStorage;
+	}
+
+	this->numVertices = numVertices;
+	localVertices = storage;
+	localNormals = storage + numVertices;
+	worldVertices = storage + 2 * numVertices;
+
+	boundingRadius = 0.0f;
+	for (int i = 0; i < numVertices; i++)
+	{
+		localVertices[i] = vertices[i];
+		worldVertices[i] = vertices[i];
+		boundingRadius = std::max(boundingRadius, vertices[i].Magnitude());
+	}
+	for (int i = 0; i < numVertices; i++)
+	{
+		localNormals[i] = EdgeAt(i).Normal();
+	}
+}
+
 ShapeType PolygonShape::GetType() const
 {
 	return POLYGON;
@@ -74,7 +172,7 @@ ShapeType PolygonShape::GetType() const
 
 Shape* PolygonShape::Clone() const
 {
-	return new PolygonShape(localVertices);
+	return new PolygonShape(localVertices, numVertices);
 }
 
 float PolygonShape::GetMomentOfInertia() const
@@ -82,10 +180,10 @@ float PolygonShape::GetMomentOfInertia() const
 	float acc0 = 0;
 	float acc1 = 0;
 
-	for (int i = 0; i < localVertices.size(); i++) 
+	for (int i = 0; i < numVertices; i++) 
 	{
 		auto a = localVertices[i];
-		auto b = localVertices[(i + 1) % localVertices.size()];
+		auto b = localVertices[(i + 1) % numVertices];
 		auto cross = abs(a.Cross(b));
 		acc0 += cross * (a.Dot(a) + b.Dot(b) + a.Dot(b));
 		acc1 += cross;
@@ -97,29 +195,29 @@ float PolygonShape::GetMomentOfInertia() const
 Vec2 PolygonShape::EdgeAt(int index) const
 {
 	int currVertex = index;
-	int nextVertex = (index + 1) % worldVertices.size();
+	int nextVertex = index + 1 < numVertices ? index + 1 : 0;
 
-	return worldVertices[nextVertex] - worldVertices[currVertex];
+	return localVertices[nextVertex] - localVertices[currVertex];
 }
 
-float PolygonShape::FindMinSeparation(const PolygonShape* other, int& indexReferenceEdge, Vec2& supportPoint) const
+float PolygonShape::FindMinSeparation(const Vec2* otherVertices, int numOtherVertices, int& indexReferenceEdge, Vec2& supportPoint) const
 {
 	float separation = std::numeric_limits<float>::lowest();
 
 	// Loop all the vertices of "this" polygon
-	for (int i = 0; i < this->worldVertices.size(); i++)
+	for (int i = 0; i < this->numVertices; i++)
 	{
-		Vec2 va = this->worldVertices[i];
-		Vec2 normal = this->EdgeAt(i).Normal();
+		const Vec2 va = this->localVertices[i];
+		const Vec2 normal = this->localNormals[i];
 
 		float minSep = std::numeric_limits<float>::max();
 		Vec2 minVertex;
 
 		// Loop all the vertices of the "other" polygon
-		for (int j = 0; j < other->worldVertices.size(); j++)
+		for (int j = 0; j < numOtherVertices; j++)
 		{
-			Vec2 vb = other->worldVertices[j];
-			float proj = (vb - va).Dot(normal);
+			const Vec2 vb = otherVertices[j];
+			float proj = (vb.x - va.x) * normal.x + (vb.y - va.y) * normal.y;
 			if (proj < minSep)
 			{
 				minSep = proj;
@@ -138,14 +236,83 @@ float PolygonShape::FindMinSeparation(const PolygonShape* other, int& indexRefer
 	return separation;
 }
 
+float PolygonShape::FindMinSeparationHillClimbing(const Vec2* otherVertices, int numOtherVertices, int& indexReferenceEdge, Vec2& supportPoint) const
+{
+	float separation = std::numeric_limits<float>::lowest();
+
+	// The deepest vertex of the other polygon along the first edge is found
+	// with a loop over all of them
+	int support = 0;
+	for (int j = 1; j < numOtherVertices; j++)
+	{
+		const Vec2 vb = otherVertices[j];
+		const Vec2 vs = otherVertices[support];
+		if ((vb.x - vs.x) * -localNormals[0].x + (vb.y - vs.y) * -localNormals[0].y > 0)
+		{
+			support = j;
+		}
+	}
+
+	for (int i = 0; i < this->numVertices; i++)
+	{
+		const Vec2 va = this->localVertices[i];
+		const Vec2 normal = this->localNormals[i];
+
+		// Both polygons are convex, so the projections of the other vertices on
+		// the normal have a single minimum. Walk from the deepest vertex of the
+		// previous edge towards it: the normals turn around once, and so does
+		// the deepest vertex, so all the walks together visit every vertex of
+		// the other polygon about once
+		const Vec2 vs = otherVertices[support];
+		float minSep = (vs.x - va.x) * normal.x + (vs.y - va.y) * normal.y;
+		while (true)
+		{
+			const int next = support + 1 < numOtherVertices ? support + 1 : 0;
+			const Vec2 vn = otherVertices[next];
+			const float nextSep = (vn.x - va.x) * normal.x + (vn.y - va.y) * normal.y;
+			if (nextSep < minSep)
+			{
+				support = next;
+				minSep = nextSep;
+				continue;
+			}
+
+			const int previous = support > 0 ? support - 1 : numOtherVertices - 1;
+			const Vec2 vp = otherVertices[previous];
+			const float previousSep = (vp.x - va.x) * normal.x + (vp.y - va.y) * normal.y;
+			if (previousSep < minSep)
+			{
+				support = previous;
+				minSep = previousSep;
+				continue;
+			}
+			break;
+		}
+
+		if (minSep > separation)
+		{
+			separation = minSep;
+			indexReferenceEdge = i;
+			supportPoint = otherVertices[support];
+
+			// Separating axis, the polygons don't touch
+			if (separation >= 0)
+			{
+				break;
+			}
+		}
+	}
+
+	return separation;
+}
+
 int PolygonShape::FindIncidentEdge(const Vec2& normal) const
 {
-	int indexIncidentEdge;
+	int indexIncidentEdge = 0;
 	float minProj = std::numeric_limits<float>::max();
-	for (int i = 0; i < this->worldVertices.size(); ++i) 
+	for (int i = 0; i < this->numVertices; ++i) 
 	{
-		auto edgeNormal = this->EdgeAt(i).Normal();
-		auto proj = edgeNormal.Dot(normal);
+		auto proj = this->localNormals[i].Dot(normal);
 		if (proj < minProj) 
 		{
 			minProj = proj;
@@ -155,37 +322,52 @@ int PolygonShape::FindIncidentEdge(const Vec2& normal) const
 	return indexIncidentEdge;
 }
 
-int PolygonShape::ClipSegmentToLine(const std::vector<Vec2>& contactsIn, std::vector<Vec2>& contactsOut, const Vec2& c0, const Vec2& c1) const
+int PolygonShape::ClipSegmentToLine(const Vec2 contactsIn[2], Vec2 contactsOut[2], const Vec2& c0, const Vec2& c1) const
 {
-	// Start with no output points
-	int numOut = 0;
-
 	// Calculate the distance of end points to the line
 	Vec2 normal = (c1 - c0).Normalize();
 	float dist0 = (contactsIn[0] - c0).Cross(normal);
 	float dist1 = (contactsIn[1] - c0).Cross(normal);
 
-	// If the points are behind the plane
+	return ClipSegment(contactsIn, contactsOut, dist0, dist1);
+}
+
+int PolygonShape::ClipSegment(const Vec2 contactsIn[2], Vec2 contactsOut[2], float dist0, float dist1)
+{
+	// Start with no output points
+	int numOut = 0;
+
+	// If the points are on different sides of the plane (one distance is negative and the other is positive)
+	Vec2 intersection;
+	if (dist0 * dist1 < 0) 
+	{
+		float totalDist = dist0 - dist1;
+
+		// Find the intersection using linear interpolation: lerp(start,end) => start + t*(end-start)
+		float t = dist0 / (totalDist);
+		intersection = contactsIn[0] + (contactsIn[1] - contactsIn[0]) * t;
+	}
+
+	// Keep the points behind the plane, the intersection takes the place of the
+	// one in front. The order never changes, so the clipped point i always comes
+	// from the same end of the segment and the contact features stay the same
+	// when a point is right on the plane (resting boxes that are aligned)
 	if (dist0 <= 0)
 	{
 		contactsOut[numOut++] = contactsIn[0];
 	}
-		
+	else if (dist1 < 0)
+	{
+		contactsOut[numOut++] = intersection;
+	}
+
 	if (dist1 <= 0)
 	{
 		contactsOut[numOut++] = contactsIn[1];
 	}
-
-	// If the points are on different sides of the plane (one distance is negative and the other is positive)
-	if (dist0 * dist1 < 0) 
+	else if (dist0 < 0)
 	{
-		float totalDist = dist0 - dist1;
-
-		// Find the intersection using linear interpolation: lerp(start,end) => start + t*(end-start)
-		float t = dist0 / (totalDist);
-		Vec2 contact = contactsIn[0] + (contactsIn[1] - contactsIn[0]) * t;
-		contactsOut[numOut] = contact;
-		numOut++;
+		contactsOut[numOut++] = intersection;
 	}
 
 	return numOut;
@@ -193,35 +375,73 @@ int PolygonShape::ClipSegmentToLine(const std::vector<Vec2>& contactsIn, std::ve
 
 
 // Function to rotate and translate polygon vertices from "local space" to "world space"
-void PolygonShape::UpdateVertices(float angle, const Vec2& position)
+void PolygonShape::UpdateVertices(const Transform& transform)
 {
 	// Loop all the vertices, transforming from local to world space
-	for (int i = 0; i < localVertices.size(); i++)
+	for (int i = 0; i < numVertices; i++)
 	{
-		// Rotate
-		worldVertices[i] = localVertices[i].Rotate(angle);
+		worldVertices[i] = transform.Apply(localVertices[i]);
+	}
+}
+
+// Function to find the world space bounds of the polygon at a given position and rotation
+AABB PolygonShape::GetAABB(const Transform& transform) const
+{
+	const float c = transform.rotation.c;
+	const float s = transform.rotation.s;
+
+	Vec2 min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	Vec2 max(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
 
-		// Translate
-		worldVertices[i] += position;
+	for (int i = 0; i < numVertices; i++)
+	{
+		const Vec2& vertex = localVertices[i];
+		float x = vertex.x * c - vertex.y * s;
+		float y = vertex.x * s + vertex.y * c;
+		min.x = std::min(min.x, x);
+		min.y = std::min(min.y, y);
+		max.x = std::max(max.x, x);
+		max.y = std::max(max.y, y);
 	}
+
+	return AABB(min + transform.position, max + transform.position);
+}
+
+
+static Pool& BoxShapePool()
+{
+	static Pool* pool = new Pool(sizeof(BoxShape));
+	return *pool;
 }
 
+void* BoxShape::operator new(std::size_t size)
+{
+	return AllocateFromPool(BoxShapePool(), size);
+}
+
+void BoxShape::operator delete(void* block, std::size_t size)
+{
+	FreeToPool(BoxShapePool(), block, size);
+}
+
+const PoolStats& BoxShape::GetPoolStats()
+{
+	return BoxShapePool().GetStats();
+}
 
 BoxShape::BoxShape(float width, float height)
 {
 	this->width = width;
 	this->height = height;
 
-	// Load the local vertices of the box polygon
-	localVertices.push_back(Vec2(-width / 2.0, -height / 2.0)); // top left
-	localVertices.push_back(Vec2(+width / 2.0, -height / 2.0)); // top right
-	localVertices.push_back(Vec2(+width / 2.0, +height / 2.0)); // bottom right
-	localVertices.push_back(Vec2(-width / 2.0, +height / 2.0)); // bottom left
-
-	worldVertices.push_back(Vec2(-width / 2.0, -height / 2.0)); // top left
-	worldVertices.push_back(Vec2(+width / 2.0, -height / 2.0)); // top right
-	worldVertices.push_back(Vec2(+width / 2.0, +height / 2.0)); // bottom right
-	worldVertices.push_back(Vec2(-width / 2.0, +height / 2.0)); // bottom left
+	// Load the local vertices of the box polygon (also used as the first world vertices)
+	const Vec2 vertices[4] = {
+		Vec2(-width / 2.0, -height / 2.0), // top left
+		Vec2(+width / 2.0, -height / 2.0), // top right
+		Vec2(+width / 2.0, +height / 2.0), // bottom right
+		Vec2(-width / 2.0, +height / 2.0)  // bottom left
+	};
+	SetVertices(vertices, 4);
 }
 
 BoxShape::~BoxShape()
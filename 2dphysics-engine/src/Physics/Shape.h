@@ -2,13 +2,17 @@
 #define SHAPE_H
 
 #include "./Vec2.h"
+#include "./AABB.h"
+#include "./Transform.h"
+#include "./Pool.h"
 #include <vector>
 
 enum ShapeType
 {
 	CIRCLE,
 	POLYGON,
-	BOX
+	BOX,
+	NUM_SHAPE_TYPES
 };
 
 struct Shape
@@ -16,8 +20,9 @@ struct Shape
 	virtual ~Shape() = default;
 	virtual ShapeType GetType() const = 0;
 	virtual Shape* Clone() const = 0;
-	virtual void UpdateVertices(float angle, const Vec2& position) = 0;
+	virtual void UpdateVertices(const Transform& transform) = 0;
 	virtual float GetMomentOfInertia() const = 0;
+	virtual AABB GetAABB(const Transform& transform) const = 0;
 };
 
 struct CircleShape: public Shape
@@ -26,33 +31,89 @@ struct CircleShape: public Shape
 
 	CircleShape(const float radius);
 	virtual ~CircleShape();
+
+	// Allocated from a pool (see Pool.h)
+	static void* operator new(std::size_t size);
+	static void operator delete(void* block, std::size_t size);
+	static const PoolStats& GetPoolStats();
 	ShapeType GetType() const override;
 	Shape* Clone() const override;
-	void UpdateVertices(float angle, const Vec2& position) override;
+	void UpdateVertices(const Transform& transform) override;
 	float GetMomentOfInertia() const override;
+	AABB GetAABB(const Transform& transform) const override;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// PolygonShape
+///////////////////////////////////////////////////////////////////////////////
+// The local vertices, the local normals and the world vertices are stored one
+// array after the other in a single block. Polygons with up to
+// MAX_INLINE_VERTICES vertices (boxes included) keep that block inside the
+// shape itself, so the collision queries read them without any indirection to
+// the heap and creating the shape doesn't allocate; bigger polygons allocate
+// a block of the exact size.
+//
+// The collision tests only use the local vertices and normals (computed once
+// when the shape is created): the vertices of the other polygon are moved into
+// the local space of this one. The world vertices are only there for whoever
+// wants to draw the polygon, they are updated by UpdateVertices() and the
+// world doesn't call it while it steps.
+///////////////////////////////////////////////////////////////////////////////
 struct PolygonShape: public Shape
 {
+	static const int MAX_INLINE_VERTICES = 8;
+
 	float width;
 	float height;
 
 	// counter-clockwise order
 	// convex polygon
-	std::vector<Vec2> localVertices;
-	std::vector<Vec2> worldVertices;
+	int numVertices = 0;
+	Vec2* localVertices = nullptr;
+	Vec2* localNormals = nullptr; // outward normal of the edge from vertex i to vertex i + 1
+	Vec2* worldVertices = nullptr;
+
+	// Distance from the center to the farthest vertex, for a quick rejection test
+	float boundingRadius = 0.0f;
 
 	PolygonShape() = default;
-	PolygonShape(const std::vector<Vec2> vertices);
+	PolygonShape(const std::vector<Vec2>& vertices);
+	PolygonShape(const Vec2* vertices, int numVertices);
+	PolygonShape(const PolygonShape& other);
+	PolygonShape& operator = (const PolygonShape& other) = delete;
 	virtual ~PolygonShape();
+
+	// Allocated from a pool (see Pool.h)
+	static void* operator new(std::size_t size);
+	static void operator delete(void* block, std::size_t size);
+	static const PoolStats& GetPoolStats();
 	ShapeType GetType() const override;
 	Shape* Clone() const override;
+	// Edge from local vertex "index" to the next one
 	Vec2 EdgeAt(int index) const;
-	float FindMinSeparation(const PolygonShape* other, int& indexReferenceEdge, Vec2& supportPoint) const;
+
+	// The vertices and the normal are in the local space of this polygon
+	float FindMinSeparation(const Vec2* otherVertices, int numOtherVertices, int& indexReferenceEdge, Vec2& supportPoint) const;
+	// Same result as FindMinSeparation() in O(n + m) instead of O(n * m) for
+	// big polygons, but it returns as soon as it finds a separating axis (so the
+	// edge and the separation are only the best ones when they overlap)
+	float FindMinSeparationHillClimbing(const Vec2* otherVertices, int numOtherVertices, int& indexReferenceEdge, Vec2& supportPoint) const;
 	int FindIncidentEdge(const Vec2& normal) const;
-	int ClipSegmentToLine(const std::vector<Vec2>& contactsIn, std::vector<Vec2>& contactsOut, const Vec2& c0, const Vec2& c1) const;
+	// The clipped points keep the order of the segment
+	int ClipSegmentToLine(const Vec2 contactsIn[2], Vec2 contactsOut[2], const Vec2& c0, const Vec2& c1) const;
+	// Same, with the signed distances of the two points to the line already known
+	static int ClipSegment(const Vec2 contactsIn[2], Vec2 contactsOut[2], float dist0, float dist1);
 	float GetMomentOfInertia() const override;
-	void UpdateVertices(float angle, const Vec2& position) override;
+	void UpdateVertices(const Transform& transform) override;
+	AABB GetAABB(const Transform& transform) const override;
+
+protected:
+	// Copies the vertices (as both local and world vertices) and computes the normals
+	void SetVertices(const Vec2* vertices, int numVertices);
+
+private:
+	Vec2 inlineStorage[3 * MAX_INLINE_VERTICES];
+	Vec2* heapStorage = nullptr;
 };
 
 struct BoxShape: public PolygonShape
@@ -62,6 +123,11 @@ struct BoxShape: public PolygonShape
 
 	BoxShape(float width, float height);
 	virtual ~BoxShape();
+
+	// Allocated from a pool (see Pool.h)
+	static void* operator new(std::size_t size);
+	static void operator delete(void* block, std::size_t size);
+	static const PoolStats& GetPoolStats();
 	ShapeType GetType() const override;
 	Shape* Clone() const override;
 	float GetMomentOfInertia() const override;
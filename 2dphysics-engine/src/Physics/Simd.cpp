@@ -0,0 +1,69 @@
+#include "Simd.h"
+
+#include <algorithm>
+
+#if IMPACT_SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+SimdLevel DetectSimdLevel()
+{
+#if IMPACT_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return SIMD_AVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return SIMD_SSE2;
+	}
+#elif IMPACT_SIMD_X86 && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+
+	// AVX also needs the OS to save the ymm registers
+	bool avxEnabled = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+	if (avxEnabled && maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		if (info[1] & (1 << 5))
+		{
+			return SIMD_AVX2;
+		}
+	}
+	if (sse2)
+	{
+		return SIMD_SSE2;
+	}
+#endif
+	return SIMD_SCALAR;
+}
+
+static SimdLevel simdLevel = DetectSimdLevel();
+
+SimdLevel GetSimdLevel()
+{
+	return simdLevel;
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+	simdLevel = std::min(level, DetectSimdLevel());
+}
+
+const char* SimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+		case SIMD_SSE2: return "SSE2";
+		case SIMD_AVX2: return "AVX2";
+		default: return "scalar";
+	}
+}
@@ -0,0 +1,35 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// The SIMD kernels are only compiled on x86, other CPUs always use the scalar ones
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IMPACT_SIMD_X86 1
+#else
+#define IMPACT_SIMD_X86 0
+#endif
+
+// GCC and Clang need to be told which functions may use AVX2, MSVC doesn't
+#if IMPACT_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define IMPACT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define IMPACT_TARGET_AVX2
+#endif
+
+enum SimdLevel
+{
+	SIMD_SCALAR,
+	SIMD_SSE2,
+	SIMD_AVX2
+};
+
+// Best instruction set supported by the CPU we are running on
+SimdLevel DetectSimdLevel();
+
+// Instruction set used by the kernels, the detected one by default. Setting a
+// level the CPU doesn't support selects the best supported one instead.
+SimdLevel GetSimdLevel();
+void SetSimdLevel(SimdLevel level);
+
+const char* SimdLevelName(SimdLevel level);
+
+#endif
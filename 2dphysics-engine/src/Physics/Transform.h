@@ -0,0 +1,75 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "./Vec2.h"
+
+#include <cmath>
+
+// Cosine and sine of an angle. Bodies keep the one of their current rotation
+// (updated once per step), so rotating points doesn't call cos/sin every time.
+// The functions are inline, the collision tests call them for every vertex.
+struct Rotation
+{
+	float c = 1.0f;
+	float s = 0.0f;
+
+	Rotation() = default;
+
+	explicit Rotation(float angle)
+	{
+		c = std::cos(angle);
+		s = std::sin(angle);
+	}
+
+	// Same as v.Rotate(angle)
+	Vec2 Rotate(const Vec2& v) const
+	{
+		return Vec2(v.x * c - v.y * s, v.x * s + v.y * c);
+	}
+
+	// Same as v.Rotate(-angle)
+	Vec2 InverseRotate(const Vec2& v) const
+	{
+		return Vec2(v.x * c + v.y * s, v.y * c - v.x * s);
+	}
+};
+
+// Position and rotation of a body, to move points between its local space and world space
+struct Transform
+{
+	Vec2 position;
+	Rotation rotation;
+
+	Transform() = default;
+
+	Transform(const Vec2& position, const Rotation& rotation) : position(position), rotation(rotation)
+	{
+	}
+
+	// Local space to world space
+	Vec2 Apply(const Vec2& point) const
+	{
+		Vec2 rotated = rotation.Rotate(point);
+		return Vec2(rotated.x + position.x, rotated.y + position.y);
+	}
+
+	// World space to local space
+	Vec2 ApplyInverse(const Vec2& point) const
+	{
+		return rotation.InverseRotate(Vec2(point.x - position.x, point.y - position.y));
+	}
+
+	// Transform from the local space of "other" to the local space of this one,
+	// so the points of one body can be checked against the other without
+	// going through world space
+	Transform Relative(const Transform& other) const
+	{
+		Transform result;
+		result.rotation.c = rotation.c * other.rotation.c + rotation.s * other.rotation.s;
+		result.rotation.s = rotation.c * other.rotation.s - rotation.s * other.rotation.c;
+		result.position = ApplyInverse(other.position);
+		return result;
+	}
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef VEC_H
+#define VEC_H
+
+///////////////////////////////////////////////////////////////////////////////
+// Fixed size vector with N components
+///////////////////////////////////////////////////////////////////////////////
+// Same operations as VecN, but the size is known at compile time and the
+// data lives on the stack, so no heap allocation ever happens. Used by the
+// constraint solver hot loop.
+///////////////////////////////////////////////////////////////////////////////
+template <int N>
+struct Vec
+{
+	float data[N];
+
+	void Zero()                                // v1.Zero()
+	{
+		for (int i = 0; i < N; i++)
+		{
+			data[i] = 0.0f;
+		}
+	}
+
+	float Dot(const Vec<N>& v) const           // v1.Dot(v2)
+	{
+		float sum = 0.0f;
+		for (int i = 0; i < N; i++)
+		{
+			sum += data[i] * v.data[i];
+		}
+		return sum;
+	}
+
+	Vec<N> operator + (const Vec<N>& v) const  // v1 + v2
+	{
+		Vec<N> result;
+		for (int i = 0; i < N; i++)
+		{
+			result.data[i] = data[i] + v.data[i];
+		}
+		return result;
+	}
+
+	Vec<N> operator - (const Vec<N>& v) const  // v1 - v2
+	{
+		Vec<N> result;
+		for (int i = 0; i < N; i++)
+		{
+			result.data[i] = data[i] - v.data[i];
+		}
+		return result;
+	}
+
+	Vec<N> operator * (const float n) const    // v1 * n
+	{
+		Vec<N> result;
+		for (int i = 0; i < N; i++)
+		{
+			result.data[i] = data[i] * n;
+		}
+		return result;
+	}
+
+	const Vec<N>& operator += (const Vec<N>& v) // v1 += v2
+	{
+		for (int i = 0; i < N; i++)
+		{
+			data[i] += v.data[i];
+		}
+		return *this;
+	}
+
+	const Vec<N>& operator -= (const Vec<N>& v) // v1 -= v2
+	{
+		for (int i = 0; i < N; i++)
+		{
+			data[i] -= v.data[i];
+		}
+		return *this;
+	}
+
+	const Vec<N>& operator *= (const float n)  // v1 *= n
+	{
+		for (int i = 0; i < N; i++)
+		{
+			data[i] *= n;
+		}
+		return *this;
+	}
+
+	float operator [] (const int index) const  // v1[index]
+	{
+		return data[index];
+	}
+
+	float& operator [] (const int index)       // v1[index]
+	{
+		return data[index];
+	}
+};
+
+#endif
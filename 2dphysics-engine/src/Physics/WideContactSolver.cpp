@@ -0,0 +1,378 @@
+#include "WideContactSolver.h"
+
+#include <cstdint>
+
+#if IMPACT_SIMD_X86
+#include <immintrin.h>
+#endif
+
+int WideContactSolver::GetWidth(SimdLevel level)
+{
+	switch (level)
+	{
+		case SIMD_AVX2: return 8;
+		case SIMD_SSE2: return 4;
+		default: return 1;
+	}
+}
+
+void WideContactSolver::Prepare(Constraint* const* constraints, const ConstraintColoring& coloring)
+{
+	level = GetSimdLevel();
+	width = GetWidth(level);
+
+	// Every color is padded to a whole number of batches
+	int numColors = coloring.GetNumColors();
+	colorBatchStart.assign(numColors + 1, 0);
+	for (int color = 0; color < numColors; color++)
+	{
+		int count;
+		coloring.GetColor(color, count);
+		colorBatchStart[color + 1] = colorBatchStart[color] + (count + width - 1) / width;
+	}
+
+	int numBatches = colorBatchStart[numColors];
+	data.assign(numBatches * NUM_FIELDS * width, 0.0f);
+	bodySlots.assign(numBatches * 2 * width, 0);
+	writeMasks.assign(numBatches * 2 * width, 0);
+	laneConstraints.assign(numBatches * width, nullptr);
+
+	for (int color = 0; color < numColors; color++)
+	{
+		int count;
+		const int* indices = coloring.GetColor(color, count);
+		for (int i = 0; i < count; i++)
+		{
+			int batch = colorBatchStart[color] + i / width;
+			int lane = i % width;
+			PenetrationConstraint* constraint = static_cast<PenetrationConstraint*>(constraints[indices[i]]);
+			laneConstraints[batch * width + lane] = constraint;
+
+			float* fields = &data[batch * NUM_FIELDS * width + lane];
+			for (int j = 0; j < 6; j++)
+			{
+				fields[(NORMAL_JACOBIAN + j) * width] = constraint->jacobian.rows[0][j];
+				fields[(TANGENT_JACOBIAN + j) * width] = constraint->jacobian.rows[1][j];
+			}
+			fields[LHS_00 * width] = constraint->lhs.rows[0][0];
+			fields[LHS_01 * width] = constraint->lhs.rows[0][1];
+			fields[LHS_10 * width] = constraint->lhs.rows[1][0];
+			fields[LHS_11 * width] = constraint->lhs.rows[1][1];
+			fields[NORMAL_MASS * width] = constraint->normalMass;
+			fields[TANGENT_MASS * width] = constraint->tangentMass;
+			fields[BIAS * width] = constraint->bias;
+			fields[FRICTION * width] = constraint->friction;
+			fields[NORMAL_LAMBDA * width] = constraint->cachedLambda[0];
+			fields[TANGENT_LAMBDA * width] = constraint->cachedLambda[1];
+			fields[INV_MASS_A * width] = constraint->a->GetInvMass();
+			fields[INV_I_A * width] = constraint->a->GetInvI();
+			fields[INV_MASS_B * width] = constraint->b->GetInvMass();
+			fields[INV_I_B * width] = constraint->b->GetInvI();
+
+			// Body::ApplyImpulse*() ignores static bodies, so they are never written back
+			bodySlots[(batch * 2) * width + lane] = constraint->a->GetHandle().index;
+			bodySlots[(batch * 2 + 1) * width + lane] = constraint->b->GetHandle().index;
+			writeMasks[(batch * 2) * width + lane] = constraint->a->IsStatic() ? 0 : -1;
+			writeMasks[(batch * 2 + 1) * width + lane] = constraint->b->IsStatic() ? 0 : -1;
+		}
+
+		// The padding lanes of the last batch read the bodies of its first lane, which
+		// no other batch writes at the same time (they are never written back)
+		for (int i = count; i % width != 0; i++)
+		{
+			int batch = colorBatchStart[color] + i / width;
+			int lane = i % width;
+			bodySlots[(batch * 2) * width + lane] = bodySlots[(batch * 2) * width];
+			bodySlots[(batch * 2 + 1) * width + lane] = bodySlots[(batch * 2 + 1) * width];
+		}
+	}
+}
+
+int WideContactSolver::GetWidth() const
+{
+	return width;
+}
+
+int WideContactSolver::GetNumColors() const
+{
+	return colorBatchStart.size() - 1;
+}
+
+void WideContactSolver::GetColorBatches(int color, int& first, int& count) const
+{
+	first = colorBatchStart[color];
+	count = colorBatchStart[color + 1] - colorBatchStart[color];
+}
+
+void WideContactSolver::SolveBatch(int batch, BodyStore& store)
+{
+	switch (level)
+	{
+		case SIMD_AVX2: SolveBatchAVX2(batch, store); break;
+		case SIMD_SSE2: SolveBatchSSE2(batch, store); break;
+		default:
+			// A batch is a single constraint
+			laneConstraints[batch]->Solve();
+			break;
+	}
+}
+
+void WideContactSolver::Finish()
+{
+	// The scalar batches already solved the constraints themselves
+	if (level == SIMD_SCALAR)
+	{
+		return;
+	}
+
+	for (int i = 0; i < (int)laneConstraints.size(); i++)
+	{
+		if (laneConstraints[i])
+		{
+			int batch = i / width;
+			int lane = i % width;
+			const float* fields = &data[batch * NUM_FIELDS * width + lane];
+			Vec<2> lambda;
+			lambda[0] = fields[NORMAL_LAMBDA * width];
+			lambda[1] = fields[TANGENT_LAMBDA * width];
+			laneConstraints[i]->SetCachedLambda(lambda);
+		}
+	}
+}
+
+#if IMPACT_SIMD_X86
+
+///////////////////////////////////////////////////////////////////////////////
+// SSE2, 4 contacts per batch
+///////////////////////////////////////////////////////////////////////////////
+
+// mask ? a : b, lane by lane
+static inline __m128 Select4(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void WideContactSolver::SolveBatchSSE2(int batch, BodyStore& store)
+{
+	float* fields = &data[batch * NUM_FIELDS * 4];
+	const int* slotsA = &bodySlots[batch * 2 * 4];
+	const int* slotsB = slotsA + 4;
+	float* velocities = reinterpret_cast<float*>(store.velocities.data());
+	float* angularVelocities = store.angularVelocities.data();
+
+	// Gather the velocities of the bodies
+	__m128 V[6];
+	V[0] = _mm_setr_ps(velocities[2 * slotsA[0]], velocities[2 * slotsA[1]], velocities[2 * slotsA[2]], velocities[2 * slotsA[3]]);
+	V[1] = _mm_setr_ps(velocities[2 * slotsA[0] + 1], velocities[2 * slotsA[1] + 1], velocities[2 * slotsA[2] + 1], velocities[2 * slotsA[3] + 1]);
+	V[2] = _mm_setr_ps(angularVelocities[slotsA[0]], angularVelocities[slotsA[1]], angularVelocities[slotsA[2]], angularVelocities[slotsA[3]]);
+	V[3] = _mm_setr_ps(velocities[2 * slotsB[0]], velocities[2 * slotsB[1]], velocities[2 * slotsB[2]], velocities[2 * slotsB[3]]);
+	V[4] = _mm_setr_ps(velocities[2 * slotsB[0] + 1], velocities[2 * slotsB[1] + 1], velocities[2 * slotsB[2] + 1], velocities[2 * slotsB[3] + 1]);
+	V[5] = _mm_setr_ps(angularVelocities[slotsB[0]], angularVelocities[slotsB[1]], angularVelocities[slotsB[2]], angularVelocities[slotsB[3]]);
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+
+	// rhs = -J * V, with the bias on the normal row
+	__m128 rhsNormal = zero;
+	__m128 rhsTangent = zero;
+	for (int j = 0; j < 6; j++)
+	{
+		rhsNormal = _mm_add_ps(rhsNormal, _mm_mul_ps(_mm_loadu_ps(fields + (NORMAL_JACOBIAN + j) * 4), V[j]));
+		rhsTangent = _mm_add_ps(rhsTangent, _mm_mul_ps(_mm_loadu_ps(fields + (TANGENT_JACOBIAN + j) * 4), V[j]));
+	}
+	rhsNormal = _mm_sub_ps(_mm_mul_ps(rhsNormal, minusOne), _mm_loadu_ps(fields + BIAS * 4));
+	rhsTangent = _mm_mul_ps(rhsTangent, minusOne);
+
+	// Two Gauss-Seidel iterations on the 2x2 system
+	const __m128 lhs00 = _mm_loadu_ps(fields + LHS_00 * 4);
+	const __m128 lhs01 = _mm_loadu_ps(fields + LHS_01 * 4);
+	const __m128 lhs10 = _mm_loadu_ps(fields + LHS_10 * 4);
+	const __m128 lhs11 = _mm_loadu_ps(fields + LHS_11 * 4);
+	const __m128 normalMass = _mm_loadu_ps(fields + NORMAL_MASS * 4);
+	const __m128 tangentMass = _mm_loadu_ps(fields + TANGENT_MASS * 4);
+	__m128 lambdaNormal = zero;
+	__m128 lambdaTangent = zero;
+	for (int iteration = 0; iteration < 2; iteration++)
+	{
+		__m128 dotNormal = _mm_add_ps(_mm_add_ps(zero, _mm_mul_ps(lhs00, lambdaNormal)), _mm_mul_ps(lhs01, lambdaTangent));
+		lambdaNormal = _mm_add_ps(lambdaNormal, _mm_mul_ps(_mm_sub_ps(rhsNormal, dotNormal), normalMass));
+		__m128 dotTangent = _mm_add_ps(_mm_add_ps(zero, _mm_mul_ps(lhs10, lambdaNormal)), _mm_mul_ps(lhs11, lambdaTangent));
+		lambdaTangent = _mm_add_ps(lambdaTangent, _mm_mul_ps(_mm_sub_ps(rhsTangent, dotTangent), tangentMass));
+	}
+
+	// Accumulate the impulses, the normal one can only push
+	const __m128 oldNormal = _mm_loadu_ps(fields + NORMAL_LAMBDA * 4);
+	const __m128 oldTangent = _mm_loadu_ps(fields + TANGENT_LAMBDA * 4);
+	__m128 cachedNormal = _mm_add_ps(oldNormal, lambdaNormal);
+	__m128 cachedTangent = _mm_add_ps(oldTangent, lambdaTangent);
+	cachedNormal = _mm_andnot_ps(_mm_cmplt_ps(cachedNormal, zero), cachedNormal);
+
+	// Keep friction between -maxFriction and maxFriction (same comparisons as std::clamp)
+	const __m128 friction = _mm_loadu_ps(fields + FRICTION * 4);
+	__m128 maxFriction = _mm_mul_ps(cachedNormal, friction);
+	__m128 minFriction = _mm_xor_ps(maxFriction, signBit);
+	__m128 clamped = Select4(_mm_cmplt_ps(maxFriction, cachedTangent), maxFriction, cachedTangent);
+	clamped = Select4(_mm_cmplt_ps(cachedTangent, minFriction), minFriction, clamped);
+	cachedTangent = Select4(_mm_cmpgt_ps(friction, zero), clamped, cachedTangent);
+
+	_mm_storeu_ps(fields + NORMAL_LAMBDA * 4, cachedNormal);
+	_mm_storeu_ps(fields + TANGENT_LAMBDA * 4, cachedTangent);
+	lambdaNormal = _mm_sub_ps(cachedNormal, oldNormal);
+	lambdaTangent = _mm_sub_ps(cachedTangent, oldTangent);
+
+	// impulses = Jt * lambda, applied with the inverse masses
+	const __m128 invMasses[6] = {
+		_mm_loadu_ps(fields + INV_MASS_A * 4), _mm_loadu_ps(fields + INV_MASS_A * 4), _mm_loadu_ps(fields + INV_I_A * 4),
+		_mm_loadu_ps(fields + INV_MASS_B * 4), _mm_loadu_ps(fields + INV_MASS_B * 4), _mm_loadu_ps(fields + INV_I_B * 4)
+	};
+	alignas(16) float result[6][4];
+	for (int j = 0; j < 6; j++)
+	{
+		__m128 impulse = _mm_add_ps(_mm_add_ps(zero, _mm_mul_ps(_mm_loadu_ps(fields + (NORMAL_JACOBIAN + j) * 4), lambdaNormal)),
+			_mm_mul_ps(_mm_loadu_ps(fields + (TANGENT_JACOBIAN + j) * 4), lambdaTangent));
+		_mm_store_ps(result[j], _mm_add_ps(V[j], _mm_mul_ps(impulse, invMasses[j])));
+	}
+
+	// Scatter the new velocities of the bodies that aren't static
+	const int* masksA = &writeMasks[batch * 2 * 4];
+	const int* masksB = masksA + 4;
+	for (int lane = 0; lane < 4; lane++)
+	{
+		if (masksA[lane])
+		{
+			velocities[2 * slotsA[lane]] = result[0][lane];
+			velocities[2 * slotsA[lane] + 1] = result[1][lane];
+			angularVelocities[slotsA[lane]] = result[2][lane];
+		}
+		if (masksB[lane])
+		{
+			velocities[2 * slotsB[lane]] = result[3][lane];
+			velocities[2 * slotsB[lane] + 1] = result[4][lane];
+			angularVelocities[slotsB[lane]] = result[5][lane];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2, 8 contacts per batch
+///////////////////////////////////////////////////////////////////////////////
+
+IMPACT_TARGET_AVX2 void WideContactSolver::SolveBatchAVX2(int batch, BodyStore& store)
+{
+	float* fields = &data[batch * NUM_FIELDS * 8];
+	const int* slotsA = &bodySlots[batch * 2 * 8];
+	const int* slotsB = slotsA + 8;
+	float* velocities = reinterpret_cast<float*>(store.velocities.data());
+	float* angularVelocities = store.angularVelocities.data();
+
+	// Gather the velocities of the bodies (x and y are interleaved, so twice the slot)
+	__m256i indicesA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slotsA));
+	__m256i indicesB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slotsB));
+	__m256i linearA = _mm256_add_epi32(indicesA, indicesA);
+	__m256i linearB = _mm256_add_epi32(indicesB, indicesB);
+	__m256 V[6];
+	V[0] = _mm256_i32gather_ps(velocities, linearA, 4);
+	V[1] = _mm256_i32gather_ps(velocities + 1, linearA, 4);
+	V[2] = _mm256_i32gather_ps(angularVelocities, indicesA, 4);
+	V[3] = _mm256_i32gather_ps(velocities, linearB, 4);
+	V[4] = _mm256_i32gather_ps(velocities + 1, linearB, 4);
+	V[5] = _mm256_i32gather_ps(angularVelocities, indicesB, 4);
+
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 minusOne = _mm256_set1_ps(-1.0f);
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+	// rhs = -J * V, with the bias on the normal row
+	__m256 rhsNormal = zero;
+	__m256 rhsTangent = zero;
+	for (int j = 0; j < 6; j++)
+	{
+		rhsNormal = _mm256_add_ps(rhsNormal, _mm256_mul_ps(_mm256_loadu_ps(fields + (NORMAL_JACOBIAN + j) * 8), V[j]));
+		rhsTangent = _mm256_add_ps(rhsTangent, _mm256_mul_ps(_mm256_loadu_ps(fields + (TANGENT_JACOBIAN + j) * 8), V[j]));
+	}
+	rhsNormal = _mm256_sub_ps(_mm256_mul_ps(rhsNormal, minusOne), _mm256_loadu_ps(fields + BIAS * 8));
+	rhsTangent = _mm256_mul_ps(rhsTangent, minusOne);
+
+	// Two Gauss-Seidel iterations on the 2x2 system
+	const __m256 lhs00 = _mm256_loadu_ps(fields + LHS_00 * 8);
+	const __m256 lhs01 = _mm256_loadu_ps(fields + LHS_01 * 8);
+	const __m256 lhs10 = _mm256_loadu_ps(fields + LHS_10 * 8);
+	const __m256 lhs11 = _mm256_loadu_ps(fields + LHS_11 * 8);
+	const __m256 normalMass = _mm256_loadu_ps(fields + NORMAL_MASS * 8);
+	const __m256 tangentMass = _mm256_loadu_ps(fields + TANGENT_MASS * 8);
+	__m256 lambdaNormal = zero;
+	__m256 lambdaTangent = zero;
+	for (int iteration = 0; iteration < 2; iteration++)
+	{
+		__m256 dotNormal = _mm256_add_ps(_mm256_add_ps(zero, _mm256_mul_ps(lhs00, lambdaNormal)), _mm256_mul_ps(lhs01, lambdaTangent));
+		lambdaNormal = _mm256_add_ps(lambdaNormal, _mm256_mul_ps(_mm256_sub_ps(rhsNormal, dotNormal), normalMass));
+		__m256 dotTangent = _mm256_add_ps(_mm256_add_ps(zero, _mm256_mul_ps(lhs10, lambdaNormal)), _mm256_mul_ps(lhs11, lambdaTangent));
+		lambdaTangent = _mm256_add_ps(lambdaTangent, _mm256_mul_ps(_mm256_sub_ps(rhsTangent, dotTangent), tangentMass));
+	}
+
+	// Accumulate the impulses, the normal one can only push
+	const __m256 oldNormal = _mm256_loadu_ps(fields + NORMAL_LAMBDA * 8);
+	const __m256 oldTangent = _mm256_loadu_ps(fields + TANGENT_LAMBDA * 8);
+	__m256 cachedNormal = _mm256_add_ps(oldNormal, lambdaNormal);
+	__m256 cachedTangent = _mm256_add_ps(oldTangent, lambdaTangent);
+	cachedNormal = _mm256_andnot_ps(_mm256_cmp_ps(cachedNormal, zero, _CMP_LT_OQ), cachedNormal);
+
+	// Keep friction between -maxFriction and maxFriction (same comparisons as std::clamp)
+	const __m256 friction = _mm256_loadu_ps(fields + FRICTION * 8);
+	__m256 maxFriction = _mm256_mul_ps(cachedNormal, friction);
+	__m256 minFriction = _mm256_xor_ps(maxFriction, signBit);
+	__m256 clamped = _mm256_blendv_ps(cachedTangent, maxFriction, _mm256_cmp_ps(maxFriction, cachedTangent, _CMP_LT_OQ));
+	clamped = _mm256_blendv_ps(clamped, minFriction, _mm256_cmp_ps(cachedTangent, minFriction, _CMP_LT_OQ));
+	cachedTangent = _mm256_blendv_ps(cachedTangent, clamped, _mm256_cmp_ps(friction, zero, _CMP_GT_OQ));
+
+	_mm256_storeu_ps(fields + NORMAL_LAMBDA * 8, cachedNormal);
+	_mm256_storeu_ps(fields + TANGENT_LAMBDA * 8, cachedTangent);
+	lambdaNormal = _mm256_sub_ps(cachedNormal, oldNormal);
+	lambdaTangent = _mm256_sub_ps(cachedTangent, oldTangent);
+
+	// impulses = Jt * lambda, applied with the inverse masses
+	const __m256 invMasses[6] = {
+		_mm256_loadu_ps(fields + INV_MASS_A * 8), _mm256_loadu_ps(fields + INV_MASS_A * 8), _mm256_loadu_ps(fields + INV_I_A * 8),
+		_mm256_loadu_ps(fields + INV_MASS_B * 8), _mm256_loadu_ps(fields + INV_MASS_B * 8), _mm256_loadu_ps(fields + INV_I_B * 8)
+	};
+	alignas(32) float result[6][8];
+	for (int j = 0; j < 6; j++)
+	{
+		__m256 impulse = _mm256_add_ps(_mm256_add_ps(zero, _mm256_mul_ps(_mm256_loadu_ps(fields + (NORMAL_JACOBIAN + j) * 8), lambdaNormal)),
+			_mm256_mul_ps(_mm256_loadu_ps(fields + (TANGENT_JACOBIAN + j) * 8), lambdaTangent));
+		_mm256_store_ps(result[j], _mm256_add_ps(V[j], _mm256_mul_ps(impulse, invMasses[j])));
+	}
+
+	// Scatter the new velocities of the bodies that aren't static
+	const int* masksA = &writeMasks[batch * 2 * 8];
+	const int* masksB = masksA + 8;
+	for (int lane = 0; lane < 8; lane++)
+	{
+		if (masksA[lane])
+		{
+			velocities[2 * slotsA[lane]] = result[0][lane];
+			velocities[2 * slotsA[lane] + 1] = result[1][lane];
+			angularVelocities[slotsA[lane]] = result[2][lane];
+		}
+		if (masksB[lane])
+		{
+			velocities[2 * slotsB[lane]] = result[3][lane];
+			velocities[2 * slotsB[lane] + 1] = result[4][lane];
+			angularVelocities[slotsB[lane]] = result[5][lane];
+		}
+	}
+}
+
+#else
+
+// No SIMD on this CPU, the level is always scalar and these are never called
+void WideContactSolver::SolveBatchSSE2(int batch, BodyStore& store)
+{
+}
+
+void WideContactSolver::SolveBatchAVX2(int batch, BodyStore& store)
+{
+}
+
+#endif
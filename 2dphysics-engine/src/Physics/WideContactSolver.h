@@ -0,0 +1,85 @@
+#ifndef WIDECONTACTSOLVER_H
+#define WIDECONTACTSOLVER_H
+
+#include "./Constraint.h"
+#include "./Coloring.h"
+#include "./BodyStore.h"
+#include "./Simd.h"
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// WideContactSolver
+///////////////////////////////////////////////////////////////////////////////
+// Solves penetration constraints 4 (SSE2) or 8 (AVX2) at a time, one per
+// SIMD lane. The constraints of a batch come from the same color, so they
+// never share a dynamic body: the velocities of the bodies are gathered from
+// the BodyStore, the normal and friction impulses are computed and clamped
+// exactly like PenetrationConstraint::Solve() does, and the new velocities
+// are scattered back. Static bodies are read but never written.
+//
+// Every lane does the same operations in the same order as the scalar code,
+// so the result is the same as solving the colors one constraint at a time.
+///////////////////////////////////////////////////////////////////////////////
+class WideContactSolver
+{
+private:
+	// Per lane values of a batch, stored field after field (one SIMD register each)
+	enum Field
+	{
+		NORMAL_JACOBIAN,                          // 6 fields: va.x, va.y, wa, vb.x, vb.y, wb
+		TANGENT_JACOBIAN = NORMAL_JACOBIAN + 6,   // 6 fields, zero when there is no friction
+		LHS_00 = TANGENT_JACOBIAN + 6,
+		LHS_01,
+		LHS_10,
+		LHS_11,
+		NORMAL_MASS,
+		TANGENT_MASS,
+		BIAS,
+		FRICTION,
+		NORMAL_LAMBDA,                            // accumulated impulses
+		TANGENT_LAMBDA,
+		INV_MASS_A,
+		INV_I_A,
+		INV_MASS_B,
+		INV_I_B,
+		NUM_FIELDS
+	};
+
+	int width = 1;
+	SimdLevel level = SIMD_SCALAR;
+
+	std::vector<float> data;                 // data[(batch * NUM_FIELDS + field) * width + lane]
+	std::vector<int> bodySlots;              // bodySlots[(batch * 2 + side) * width + lane], side 0 = a, 1 = b
+	std::vector<int> writeMasks;             // same layout, -1 if the lane writes its body back (not static, not padding)
+	std::vector<PenetrationConstraint*> laneConstraints; // batch * width + lane, nullptr for padding lanes
+	std::vector<int> colorBatchStart;        // first batch of every color
+
+	void SolveBatchSSE2(int batch, BodyStore& store);
+	void SolveBatchAVX2(int batch, BodyStore& store);
+
+public:
+	WideContactSolver() = default;
+	~WideContactSolver() = default;
+
+	// Number of lanes of a batch for an instruction set (1 for scalar)
+	static int GetWidth(SimdLevel level);
+
+	// Packs the colored constraints (after their PreSolve()) into batches for
+	// the current SIMD level. The overflow group is left to the scalar solver.
+	void Prepare(Constraint* const* constraints, const ConstraintColoring& coloring);
+
+	int GetWidth() const;
+	int GetNumColors() const;
+
+	// Batches of a color, which can be solved in parallel
+	void GetColorBatches(int color, int& first, int& count) const;
+
+	// Runs one Solve() on every lane of a batch
+	void SolveBatch(int batch, BodyStore& store);
+
+	// Copies the accumulated impulses back to the constraints
+	void Finish();
+};
+
+#endif
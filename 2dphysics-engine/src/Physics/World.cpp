@@ -1,13 +1,16 @@
 #include "World.h"
 #include "Constants.h"
-#include "CollisionDetection.h"
 
+#include <algorithm>
 #include <iostream>
+#include <new>
 
 World::World(float gravity)
 {
 	// Expected to enter a negative number (-9.8) for gravity because it is a downward force
 	G = -gravity;
+	broadphase = new AABBTree();
+	jobSystem = new JobSystem(1);
 	std::cout << "World constructor called!" << std::endl;
 }
 
@@ -23,12 +26,71 @@ World::~World()
 		delete constraint;
 	}
 
+	delete broadphase;
+	delete jobSystem;
+
 	std::cout << "World destructor called!" << std::endl;
 }
 
 void World::AddBody(Body* body)
 {
 	bodies.push_back(body);
+	body->index = bodies.size() - 1;
+
+	// From now on the motion state of the body lives in the world's arrays
+	body->AttachToStore(&bodyStore);
+
+	// The proxy index is the index of the body in the bodies vector
+	AABB aabb = body->shape->GetAABB(body->GetTransform());
+	broadphase->CreateProxy(bodies.size() - 1, aabb, body->IsStatic());
+}
+
+void World::RemoveBody(Body* body)
+{
+	// Wake up whatever was resting on the body, it has to fall now
+	touchingBodies.clear();
+	manifolds.RemoveBody(body, touchingBodies);
+	for (int i = 0; i < (int)constraints.size();)
+	{
+		Constraint* constraint = constraints[i];
+		if (constraint->a == body || constraint->b == body)
+		{
+			touchingBodies.push_back(constraint->a == body ? constraint->b : constraint->a);
+			delete constraint;
+			constraints.erase(constraints.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+	for (auto touching : touchingBodies)
+	{
+		Body* other = bodies[touching->index];
+		if (!other->IsAwake())
+		{
+			other->SetAwake(true);
+		}
+	}
+
+	// Move the last body into the hole, the proxy index must follow the body index
+	int index = body->index;
+	int last = bodies.size() - 1;
+	broadphase->DestroyProxy(index);
+	if (index != last)
+	{
+		Body* moved = bodies[last];
+		broadphase->DestroyProxy(last);
+		bodies[index] = moved;
+		moved->index = index;
+
+		AABB aabb = moved->shape->GetAABB(moved->GetTransform());
+		broadphase->CreateProxy(index, aabb, moved->IsStatic());
+	}
+	bodies.pop_back();
+
+	// Also frees its slot of the body store
+	delete body;
 }
 
 std::vector<Body*>& World::GetBodies()
@@ -36,6 +98,16 @@ std::vector<Body*>& World::GetBodies()
 	return bodies;
 }
 
+Body* World::GetBody(BodyHandle handle) const
+{
+	if (!bodyStore.IsValid(handle))
+	{
+		return nullptr;
+	}
+
+	return bodyStore.owners[handle.index];
+}
+
 void World::AddConstraint(Constraint* constraint)
 {
 	constraints.push_back(constraint);
@@ -49,108 +121,589 @@ std::vector<Constraint*>& World::GetConstraints()
 void World::AddForce(const Vec2& force)
 {
 	forces.push_back(force);
+
+	// Sleeping bodies ignore forces, so they have to feel the new one
+	WakeAllBodies();
 }
 
 void World::AddTorque(const float torque)
 {
 	torques.push_back(torque);
+	WakeAllBodies();
 }
 
-void World::Update(float dt)
+void World::SetBroadphase(Broadphase* broadphase)
+{
+	// The world takes ownership of the new broadphase
+	delete this->broadphase;
+	this->broadphase = broadphase;
+
+	// Register all the existing bodies with the new broadphase
+	for (int i = 0; i < (int)bodies.size(); i++)
+	{
+		Body* body = bodies[i];
+		AABB aabb = body->shape->GetAABB(body->GetTransform());
+		broadphase->CreateProxy(i, aabb, body->IsStatic());
+	}
+}
+
+const Broadphase* World::GetBroadphase() const
 {
-	// Create a vector of constraints that will be solved frame per frame
-	std::vector<PenetrationConstraint> penetrations;
+	return broadphase;
+}
+
+void World::SetWarmStarting(bool enabled)
+{
+	warmStarting = enabled;
+}
 
-	// Loop all the bodies of the world applying forces
-	for (auto& body : bodies)
+bool World::IsWarmStarting() const
+{
+	return warmStarting;
+}
+
+void World::SetSolverIterations(int iterations)
+{
+	solverIterations = iterations;
+}
+
+int World::GetSolverIterations() const
+{
+	return solverIterations;
+}
+
+void World::SetAllowSleeping(bool allow)
+{
+	allowSleeping = allow;
+	if (!allowSleeping)
 	{
-		// Apply the "weight" force to all the bodies
-		Vec2 weight = Vec2(0.0, body->mass * G * PIXELS_PER_METER);
-		body->AddForce(weight);
+		WakeAllBodies();
+	}
+}
 
-		// Apply forces to all bodies
-		for (auto force : forces)
+bool World::GetAllowSleeping() const
+{
+	return allowSleeping;
+}
+
+void World::WakeAllBodies()
+{
+	for (auto body : bodies)
+	{
+		if (!body->IsAwake())
 		{
-			body->AddForce(force);
+			body->SetAwake(true);
 		}
+	}
+}
+
+const IslandStats& World::GetIslandStats() const
+{
+	return islands.GetStats();
+}
+
+void World::SetNumThreads(int numThreads)
+{
+	delete jobSystem;
+	jobSystem = new JobSystem(numThreads);
+}
+
+int World::GetNumThreads() const
+{
+	return jobSystem->GetNumThreads();
+}
+
+void World::SetGraphColoring(bool enabled)
+{
+	graphColoring = enabled;
+}
+
+bool World::GetGraphColoring() const
+{
+	return graphColoring;
+}
+
+void World::SetWideContactSolver(bool enabled)
+{
+	wideContactSolver = enabled;
+}
+
+bool World::GetWideContactSolver() const
+{
+	return wideContactSolver;
+}
+
+const FrameArenaStats& World::GetFrameArenaStats() const
+{
+	return frameArena.GetStats();
+}
+
+int World::GetNumContacts() const
+{
+	return numPenetrations;
+}
+
+const StepStats& World::GetStepStats() const
+{
+	return profiler.GetStats();
+}
+
+void World::SetTracing(bool enabled)
+{
+	profiler.SetTracing(enabled);
+}
+
+bool World::IsTracing() const
+{
+	return profiler.IsTracing();
+}
+
+bool World::WriteTrace(const char* fileName) const
+{
+	return profiler.WriteTrace(fileName);
+}
+
+// Static and sleeping bodies don't move by themselves
+static bool IsSimulated(const Body* body)
+{
+	return !body->IsStatic() && body->IsAwake();
+}
+
+// Number of constraints (or bodies) of a color in every job
+static const int COLOR_BATCH_SIZE = 32;
+
+// The constraints of a pair of bodies are always next to each other,
+// returns how many of them start at "first"
+static int CountPairPenetrations(const PenetrationConstraint* penetrations, int numPenetrations, int first)
+{
+	int count = 1;
+	while (first + count < numPenetrations && penetrations[first + count].a == penetrations[first].a && penetrations[first + count].b == penetrations[first].b)
+	{
+		count++;
+	}
+	return count;
+}
+
+void World::IntegrateForces(float dt)
+{
+	// The weight of a body is mass * gravity, so it accelerates every body the same way
+	Vec2 gravity = Vec2(0.0, G * PIXELS_PER_METER);
+
+	// The global forces and torques are applied to all bodies
+	Vec2 force = Vec2(0.0, 0.0);
+	for (auto f : forces)
+	{
+		force += f;
+	}
+
+	float torque = 0.0;
+	for (auto t : torques)
+	{
+		torque += t;
+	}
+
+	int numBatches = (bodyStore.GetNumSlots() + INTEGRATION_BATCH_SIZE - 1) / INTEGRATION_BATCH_SIZE;
+	jobSystem->ParallelFor(numBatches, 1, [&](int batch, int thread)
+	{
+		int begin = batch * INTEGRATION_BATCH_SIZE;
+		int end = std::min(begin + INTEGRATION_BATCH_SIZE, bodyStore.GetNumSlots());
+		bodyStore.IntegrateForces(begin, end, gravity, force, torque, dt);
+	});
+}
+
+void World::IntegrateVelocities(float dt)
+{
+	int numBatches = (bodyStore.GetNumSlots() + INTEGRATION_BATCH_SIZE - 1) / INTEGRATION_BATCH_SIZE;
+	jobSystem->ParallelFor(numBatches, 1, [&](int batch, int thread)
+	{
+		int begin = batch * INTEGRATION_BATCH_SIZE;
+		int end = std::min(begin + INTEGRATION_BATCH_SIZE, bodyStore.GetNumSlots());
+		bodyStore.IntegrateVelocities(begin, end, dt);
+
+		// The cos/sin of the new rotations are used by everything until the next step.
+		// The world vertices of the polygons are not updated, the collision tests don't need them
+		bodyStore.UpdateRotations(begin, end);
+	});
+}
+
+void World::PreSolveIsland(int island, float dt)
+{
+	int numJoints, numPenetrations;
+	const int* islandJoints = islands.GetIslandJoints(island, numJoints);
+	const int* islandPenetrations = islands.GetIslandPenetrations(island, numPenetrations);
+
+	// PreSolve Joint Constraints
+	for (int i = 0; i < numJoints; i++)
+	{
+		constraints[islandJoints[i]]->PreSolve(dt);
+	}
+
+	// PreSolve Penetration Constraints
+	for (int i = 0; i < numPenetrations; i++)
+	{
+		penetrations[islandPenetrations[i]].PreSolve(dt);
+	}
+}
+
+void World::SolveIsland(int island)
+{
+	int numJoints, numPenetrations;
+	const int* islandJoints = islands.GetIslandJoints(island, numJoints);
+	const int* islandPenetrations = islands.GetIslandPenetrations(island, numPenetrations);
 
-		// Apply torque to all bodies
-		for (auto torque : torques)
+	// Solve all the constraints
+	for (int iteration = 0; iteration < solverIterations; iteration++)
+	{
+		for (int i = 0; i < numJoints; i++) // joint constraints
+		{
+			constraints[islandJoints[i]]->Solve();
+		}
+
+		for (int i = 0; i < numPenetrations; i++) // penetration constraints
 		{
-			body->AddTorque(torque);
+			penetrations[islandPenetrations[i]].Solve();
 		}
 	}
+}
+
+void World::PostSolveIsland(int island)
+{
+	int numJoints, numPenetrations;
+	const int* islandJoints = islands.GetIslandJoints(island, numJoints);
+	const int* islandPenetrations = islands.GetIslandPenetrations(island, numPenetrations);
+
+	// Postsolve all the joint constraints
+	for (int i = 0; i < numJoints; i++)
+	{
+		constraints[islandJoints[i]]->PostSolve();
+	}
+
+	// Postsolve all the penetration constraints
+	for (int i = 0; i < numPenetrations; i++)
+	{
+		penetrations[islandPenetrations[i]].PostSolve();
+	}
+}
+
+template<typename Function>
+void World::ForEachColor(const ConstraintColoring& coloring, const std::vector<Constraint*>& constraints, const Function& function)
+{
+	int count;
+	for (int color = 0; color < coloring.GetNumColors(); color++)
+	{
+		const int* indices = coloring.GetColor(color, count);
+		jobSystem->ParallelFor(count, COLOR_BATCH_SIZE, [&](int i, int thread)
+		{
+			function(constraints[indices[i]]);
+		});
+	}
 
-	// Integrate all the forces
-	for (auto& body: bodies)
+	// The overflow group shares bodies, so it is solved serially
+	const int* indices = coloring.GetColor(coloring.GetNumColors(), count);
+	for (int i = 0; i < count; i++)
 	{
-		body->IntegrateForces(dt);
+		function(constraints[indices[i]]);
 	}
+}
 
-	// Check all the rigidbodies with the other rigidbodies for collision
-	for (int i = 0; i <= bodies.size() - 1; i++)
+void World::SolvePenetrationsWide()
+{
+	// Same order as ForEachColor(), but every job solves whole SIMD batches
+	int batchesPerJob = std::max(1, COLOR_BATCH_SIZE / wideSolver.GetWidth());
+	for (int color = 0; color < wideSolver.GetNumColors(); color++)
 	{
-		for (int j = i + 1; j < bodies.size(); j++)
+		int first, count;
+		wideSolver.GetColorBatches(color, first, count);
+		jobSystem->ParallelFor(count, batchesPerJob, [&](int i, int thread)
+		{
+			wideSolver.SolveBatch(first + i, bodyStore);
+		});
+	}
+
+	int count;
+	const int* indices = penetrationColoring.GetColor(penetrationColoring.GetNumColors(), count);
+	for (int i = 0; i < count; i++)
+	{
+		coloredPenetrations[indices[i]]->Solve();
+	}
+}
+
+void World::SolveIslandColored(int island, float dt)
+{
+	// Same steps as the small islands, but the constraints of every color run
+	// in parallel. The coloring counts as part of the PreSolve phase
+	bool wide = wideContactSolver && GetSimdLevel() != SIMD_SCALAR;
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_PRESOLVE);
+
+		int numJoints, numPenetrations;
+		const int* jointIndices = islands.GetIslandJoints(island, numJoints);
+		const int* penetrationIndices = islands.GetIslandPenetrations(island, numPenetrations);
+
+		coloredJoints.clear();
+		for (int i = 0; i < numJoints; i++)
+		{
+			coloredJoints.push_back(constraints[jointIndices[i]]);
+		}
+		coloredPenetrations.clear();
+		for (int i = 0; i < numPenetrations; i++)
 		{
-			Body* a = bodies[i];
-			Body* b = bodies[j];
+			coloredPenetrations.push_back(&penetrations[penetrationIndices[i]]);
+		}
+
+		jointColoring.Build(coloredJoints.data(), coloredJoints.size(), bodies.size());
+		penetrationColoring.Build(coloredPenetrations.data(), coloredPenetrations.size(), bodies.size());
 
-			std::vector<Contact> contacts;
+		ForEachColor(jointColoring, coloredJoints, [dt](Constraint* constraint) { constraint->PreSolve(dt); });
+		ForEachColor(penetrationColoring, coloredPenetrations, [dt](Constraint* constraint) { constraint->PreSolve(dt); });
+
+		if (wide)
+		{
+			wideSolver.Prepare(coloredPenetrations.data(), penetrationColoring);
+		}
+	}
 
-			if (CollisionDetection::IsColliding(a, b, contacts))
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_SOLVE);
+		for (int iteration = 0; iteration < solverIterations; iteration++)
+		{
+			ForEachColor(jointColoring, coloredJoints, [](Constraint* constraint) { constraint->Solve(); });
+			if (wide)
+			{
+				SolvePenetrationsWide();
+			}
+			else
 			{
-				for (auto contact: contacts)
-				{
-					// Create a new penetration constraint
-					PenetrationConstraint penetration(contact.a, contact.b, contact.start, contact.end, contact.normal);
-					penetrations.push_back(penetration);
-				}
+				ForEachColor(penetrationColoring, coloredPenetrations, [](Constraint* constraint) { constraint->Solve(); });
 			}
 		}
 	}
 
-	// Solve all constraints
-	// PreSolve Joint Constraints
-	for (auto& constraint : constraints)
 	{
-		constraint->PreSolve(dt);
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_POSTSOLVE);
+		if (wide)
+		{
+			wideSolver.Finish();
+		}
+
+		ForEachColor(jointColoring, coloredJoints, [](Constraint* constraint) { constraint->PostSolve(); });
+		ForEachColor(penetrationColoring, coloredPenetrations, [](Constraint* constraint) { constraint->PostSolve(); });
+	}
+}
+
+void World::FindContactsAndIslands()
+{
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_BROADPHASE);
+
+		// Sleeping bodies don't need to be paired with each other, so the broadphase treats them as static
+		for (int i = 0; i < (int)bodies.size(); i++)
+		{
+			broadphase->SetProxyStatic(i, !IsSimulated(bodies[i]));
+		}
+
+		// Find the pairs of bodies whose bounds overlap
+		broadphase->FindPairs(pairs);
 	}
 
-	// PreSolve Penetration Constraints
-	for (auto& constraint : penetrations)
 	{
-		constraint.PreSolve(dt);
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_NARROWPHASE);
+
+		// Check the broadphase pairs for collision (in parallel)
+		narrowphase.FindContacts(bodies, pairs, *jobSystem, frameArena);
 	}
 
-	// Solve all the constraints
-	for (int i = 0; i < 9; i++)
 	{
-		for (auto& constraint : constraints) // joint constraints
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_CONTACTS);
+
+		// Create a new penetration constraint for every contact. They are never
+		// destroyed, the arena just reuses their memory in the next step
+		int numContacts;
+		const Contact* contacts = narrowphase.GetContacts(numContacts);
+		penetrations = frameArena.AllocateArray<PenetrationConstraint>(numContacts);
+		numPenetrations = numContacts;
+		for (int i = 0; i < numContacts; i++)
 		{
-			constraint->Solve();
+			const Contact& contact = contacts[i];
+			new (&penetrations[i]) PenetrationConstraint(contact.a, contact.b, contact.start, contact.end, contact.normal, contact.feature);
 		}
 
-		for (auto& constraint : penetrations) // penetration constraints
+		// Start from the impulses the same contacts had in the previous frame
+		if (warmStarting)
 		{
-			constraint.Solve();
+			for (int i = 0; i < numPenetrations;)
+			{
+				int count = CountPairPenetrations(penetrations, numPenetrations, i);
+				manifolds.WarmStart(&penetrations[i], count);
+				i += count;
+			}
 		}
 	}
 
-	// Postsolve all the joint constraints
-	for (auto& constraint : constraints)
 	{
-		constraint->PostSolve();
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_ISLANDS);
+
+		// Build the islands from the joints, the new contacts and the contacts
+		// of the sleeping bodies
+		islands.Reset(bodies.size());
+		for (auto& constraint : constraints)
+		{
+			islands.Link(constraint->a, constraint->b);
+		}
+		for (int i = 0; i < numPenetrations; i++)
+		{
+			islands.Link(penetrations[i].a, penetrations[i].b);
+		}
+		manifolds.LinkIslands(islands);
+		islands.Build(bodies);
+		islands.BuildConstraints(constraints, penetrations, numPenetrations);
 	}
+}
 
-	// Postsolve all the penetration constraints
-	for (auto& constraint : penetrations)
+void World::Update(float dt)
+{
+	profiler.BeginStep();
+	StepStats& stats = profiler.GetStats();
+
+	// Everything allocated from the arena during the previous step is gone
+	frameArena.Reset();
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_BROADPHASE);
+
+		// Bodies moved by hand since the last step. The proxies of the moving
+		// bodies are updated at the end of every step, but not the ones of
+		// static and sleeping bodies
+		for (int slot : bodyStore.movedSlots)
+		{
+			if (!(bodyStore.flags[slot] & BodyStore::BODY_MOVED))
+			{
+				continue; // destroyed since it moved
+			}
+			bodyStore.flags[slot] &= ~BodyStore::BODY_MOVED;
+
+			Body* body = bodyStore.owners[slot];
+			AABB aabb = body->shape->GetAABB(body->GetTransform());
+			broadphase->MoveProxy(body->index, aabb, Vec2());
+		}
+		bodyStore.movedSlots.clear();
+	}
+
+	// An island woken up by an awake body has no contacts between its own
+	// bodies, the narrowphase skipped them while they were sleeping. So the
+	// pairs, the contacts and the islands are found again until no island
+	// wakes up, before anything moves
+	do
 	{
-		constraint.PostSolve();
+		FindContactsAndIslands();
 	}
+	while (islands.WakeIslands(bodies));
+	stats.pairs = pairs.size();
+	stats.contacts = numPenetrations;
 
-	// Integrate all the velocities
-	for (auto& body : bodies)
 	{
-		body->IntegrateVelocities(dt);
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_INTEGRATE_FORCES);
+
+		// Apply the forces to the awake bodies and integrate them
+		IntegrateForces(dt);
 	}
+
+	// Islands don't share any dynamic body, so they can be solved in parallel
+	// and the result doesn't depend on the number of threads. Small islands
+	// go through PreSolve, the iterations and PostSolve in three passes, every
+	// island still sees the same operations in the same order. A single large
+	// island would keep only one thread busy, so those are solved one after
+	// the other with their constraints split by color
+	smallIslands.clear();
+	for (int island = 0; island < islands.GetNumIslands(); island++)
+	{
+		if (!islands.IsIslandAwake(island, bodies))
+		{
+			continue;
+		}
+
+		int numJoints, numPenetrations;
+		islands.GetIslandJoints(island, numJoints);
+		islands.GetIslandPenetrations(island, numPenetrations);
+		stats.constraints += numJoints + numPenetrations;
+
+		if (graphColoring && numJoints + numPenetrations >= MIN_COLORED_ISLAND_CONSTRAINTS)
+		{
+			SolveIslandColored(island, dt);
+		}
+		else if (numJoints + numPenetrations > 0)
+		{
+			smallIslands.push_back(island);
+		}
+	}
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_PRESOLVE);
+		jobSystem->ParallelFor(smallIslands.size(), 1, [&](int i, int thread)
+		{
+			PreSolveIsland(smallIslands[i], dt);
+		});
+	}
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_SOLVE);
+		jobSystem->ParallelFor(smallIslands.size(), 1, [&](int i, int thread)
+		{
+			SolveIsland(smallIslands[i]);
+		});
+	}
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_POSTSOLVE);
+		jobSystem->ParallelFor(smallIslands.size(), 1, [&](int i, int thread)
+		{
+			PostSolveIsland(smallIslands[i]);
+		});
+	}
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_INTEGRATE_VELOCITIES);
+
+		// Integrate all the velocities of the awake bodies
+		IntegrateVelocities(dt);
+	}
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_CONTACTS);
+
+		// Save the accumulated impulses of every pair of bodies for the next frame
+		for (int i = 0; i < numPenetrations;)
+		{
+			int count = CountPairPenetrations(penetrations, numPenetrations, i);
+			manifolds.Store(&penetrations[i], count);
+			i += count;
+		}
+		manifolds.RemoveStale();
+	}
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_BROADPHASE);
+
+		// Update the broadphase with the new bounds of the bodies that moved
+		for (int i = 0; i < (int)bodies.size(); i++)
+		{
+			Body* body = bodies[i];
+			if (!IsSimulated(body))
+			{
+				continue;
+			}
+
+			AABB aabb = body->shape->GetAABB(body->GetTransform());
+			broadphase->MoveProxy(i, aabb, body->GetVelocity() * dt);
+		}
+	}
+
+	{
+		IMPACT_PROFILE_SCOPE(profiler, PHASE_ISLANDS);
+
+		// Put to sleep the islands that have been resting for long enough
+		islands.UpdateSleep(bodies, dt, allowSleeping);
+	}
+
+	profiler.EndStep();
 }
@@ -2,7 +2,17 @@
 #define WORLD_H
 
 #include "./Body.h"
+#include "./BodyStore.h"
 #include "./Constraint.h"
+#include "./Broadphase.h"
+#include "./Manifold.h"
+#include "./Island.h"
+#include "./JobSystem.h"
+#include "./Narrowphase.h"
+#include "./Coloring.h"
+#include "./WideContactSolver.h"
+#include "./FrameArena.h"
+#include "./Profiler.h"
 
 #include <vector>
 
@@ -11,24 +21,138 @@ class World {
 private:
 	float G = 9.8;
 	std::vector<Body*> bodies;
+
+	// Motion state of the bodies, in contiguous arrays
+	BodyStore bodyStore;
 	std::vector<Constraint*> constraints;
 
 	std::vector<Vec2> forces;
 	std::vector<float> torques;
 
+	// Finds the pairs of bodies that need to be checked by the narrowphase
+	Broadphase* broadphase;
+	std::vector<BroadphasePair> pairs;
+
+	// Impulses of the contacts of the previous frame, used for warm starting
+	ManifoldCache manifolds;
+	std::vector<const Body*> touchingBodies; // scratch list of RemoveBody()
+
+	bool warmStarting = true;
+	int solverIterations = 8;
+
+	// Finds the contacts of the broadphase pairs
+	Narrowphase narrowphase;
+
+	// Memory of the contacts and penetrations of the current step, reset by every Update()
+	FrameArena frameArena;
+
+	// Contacts of the current step (in the frame arena)
+	PenetrationConstraint* penetrations = nullptr;
+	int numPenetrations = 0;
+
+	// Groups of connected bodies, solved independently and put to sleep as a whole
+	IslandGraph islands;
+	bool allowSleeping = true;
+
+	// Worker threads that solve the islands in parallel
+	JobSystem* jobSystem;
+
+	// Large islands are solved one at a time, with their constraints split by color
+	bool graphColoring = true;
+	std::vector<Constraint*> coloredJoints;
+	std::vector<Constraint*> coloredPenetrations;
+	ConstraintColoring jointColoring;
+	ConstraintColoring penetrationColoring;
+
+	// Solves the penetrations of every color several at a time with SIMD
+	bool wideContactSolver = true;
+	WideContactSolver wideSolver;
+
+	// Awake islands that are too small for graph coloring, solved in parallel
+	std::vector<int> smallIslands;
+
+	// Times the phases of every step and counts what they did
+	StepProfiler profiler;
+
+	// Broadphase, narrowphase and islands of the current step
+	void FindContactsAndIslands();
+	void IntegrateForces(float dt);
+	void IntegrateVelocities(float dt);
+	void PreSolveIsland(int island, float dt);
+	void SolveIsland(int island);
+	void PostSolveIsland(int island);
+	void SolveIslandColored(int island, float dt);
+	void SolvePenetrationsWide();
+	template<typename Function>
+	void ForEachColor(const ConstraintColoring& coloring, const std::vector<Constraint*>& constraints, const Function& function);
+
 public:
+	// Islands with at least this many constraints are solved with graph coloring
+	static const int MIN_COLORED_ISLAND_CONSTRAINTS = 256;
+
+	// Number of bodies integrated by every job
+	static const int INTEGRATION_BATCH_SIZE = 1024;
+
 	World(float gravity);
 	~World();
 
 	void AddBody(Body* body);
+
+	// Deletes the body and the joints attached to it. The last body of the list
+	// takes its place (and its index), the bodies it was touching wake up
+	void RemoveBody(Body* body);
 	std::vector<Body*>& GetBodies();
 
+	// Returns nullptr if the body of the handle doesn't exist anymore
+	Body* GetBody(BodyHandle handle) const;
+
 	void AddConstraint(Constraint* constraint);
 	std::vector<Constraint*>& GetConstraints();
 
 	void AddForce(const Vec2& force);
 	void AddTorque(const float torque);
 
+	void SetBroadphase(Broadphase* broadphase);
+	const Broadphase* GetBroadphase() const;
+
+	void SetWarmStarting(bool enabled);
+	bool IsWarmStarting() const;
+
+	void SetSolverIterations(int iterations);
+	int GetSolverIterations() const;
+
+	void SetAllowSleeping(bool allow);
+	bool GetAllowSleeping() const;
+	void WakeAllBodies();
+	const IslandStats& GetIslandStats() const;
+
+	// Number of threads used to step the world (1 by default, the calling thread included)
+	void SetNumThreads(int numThreads);
+	int GetNumThreads() const;
+
+	void SetGraphColoring(bool enabled);
+	bool GetGraphColoring() const;
+
+	// Only used for the islands solved with graph coloring, and when the CPU has SSE2 or AVX2
+	void SetWideContactSolver(bool enabled);
+	bool GetWideContactSolver() const;
+
+	// Memory used by the contacts of a step, it stops growing once it fits the busiest step
+	const FrameArenaStats& GetFrameArenaStats() const;
+
+	// Contacts found by the last Update()
+	int GetNumContacts() const;
+
+	// Time of every phase of the last Update() (zero when built with
+	// IMPACT_PROFILING=0) and the number of pairs, contacts and constraints
+	const StepStats& GetStepStats() const;
+
+	// Records the phases of every step until tracing is disabled, and writes
+	// them as a Chrome trace (open it in chrome://tracing or Perfetto)
+	void SetTracing(bool enabled);
+	bool IsTracing() const;
+	bool WriteTrace(const char* fileName) const;
+
 	void Update(float dt);
 };
 